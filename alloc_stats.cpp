@@ -0,0 +1,34 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_stats.h"
+
+static std::atomic<size_t> allocationCount(0);
+static std::atomic<size_t> allocationBytes(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t size) noexcept {
+    std::free(memory);
+}
+
+size_t AllocStats::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+size_t AllocStats::allocatedBytes() {
+    return allocationBytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,14 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <cstddef>
+
+// Counts every call to the global operator new made by the process, so
+// benchmarks can report how many heap allocations a script caused.
+class AllocStats {
+    public:
+        static size_t allocations();
+        static size_t allocatedBytes();
+};
+
+#endif
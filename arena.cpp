@@ -0,0 +1,47 @@
+#include <cstdint>
+
+#include "arena.h"
+
+Arena::Arena() {
+    this->cursor = nullptr;
+    this->limit = nullptr;
+    this->bytesUsed = 0;
+    this->bytesReserved = 0;
+}
+
+Arena::~Arena() {
+    for (auto it = finalizers.rbegin(); it != finalizers.rend(); ++it) {
+        it->destroy(it->object);
+    }
+    for (char* block : blocks) {
+        delete[] block;
+    }
+}
+
+void Arena::newBlock(size_t minimum) {
+    size_t size = minimum > BLOCK_SIZE ? minimum : BLOCK_SIZE;
+    char* block = new char[size];
+    blocks.push_back(block);
+    bytesReserved += size;
+    cursor = block;
+    limit = block + size;
+}
+
+void* Arena::allocateRaw(size_t size, size_t alignment) {
+    uintptr_t aligned = ((uintptr_t) cursor + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    if (cursor == nullptr || aligned + size > (uintptr_t) limit) {
+        newBlock(size + alignment);
+        aligned = ((uintptr_t) cursor + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    }
+    cursor = (char*) (aligned + size);
+    bytesUsed += size;
+    return (void*) aligned;
+}
+
+size_t Arena::getBytesUsed() {
+    return bytesUsed;
+}
+
+size_t Arena::getBytesReserved() {
+    return bytesReserved;
+}
@@ -0,0 +1,63 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+// Bump allocator that owns the tokens and syntax tree of one compilation.
+// Objects are placed back to back in large blocks and all of them go away
+// together when the arena is destroyed, so nothing has to walk the tree to
+// free it. Objects that own heap memory of their own (the vectors inside
+// Block or Call nodes, token lexemes) have their destructors recorded and run
+// at teardown; trivially destructible objects cost nothing to free.
+class Arena {
+    private:
+        static const size_t BLOCK_SIZE = 64 * 1024;
+
+        class Finalizer {
+            public:
+                void (*destroy)(void*);
+                void* object;
+        };
+
+        std::vector<char*> blocks;
+        char* cursor;
+        char* limit;
+        std::vector<Finalizer> finalizers;
+        size_t bytesUsed;
+        size_t bytesReserved;
+
+        void* allocateRaw(size_t size, size_t alignment);
+        void newBlock(size_t minimum);
+
+        template <typename T>
+        static void destroy(void* object) {
+            static_cast<T*>(object)->~T();
+        }
+
+    public:
+        Arena();
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        template <typename T, typename... Args>
+        T* make(Args&&... args) {
+            void* memory = allocateRaw(sizeof(T), alignof(T));
+            T* object = new (memory) T(std::forward<Args>(args)...);
+            if (!std::is_trivially_destructible<T>::value) {
+                finalizers.push_back(Finalizer{&Arena::destroy<T>, object});
+            }
+            return object;
+        }
+
+        // bytes handed out to objects, and bytes reserved from the system
+        size_t getBytesUsed();
+        size_t getBytesReserved();
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "value.h"
+
+enum OpCode : uint8_t {
+  // Constants and literals.
+  OP_CONSTANT, OP_NIL, OP_TRUE, OP_FALSE, OP_POP,
+
+  // Variables. Locals and upvalues take a one byte slot, globals, constants
+  // and closures a two byte index.
+  OP_GET_LOCAL, OP_SET_LOCAL,
+  OP_GET_GLOBAL, OP_DEFINE_GLOBAL, OP_SET_GLOBAL,
+  OP_GET_UPVALUE, OP_SET_UPVALUE,
+
+  // Operators.
+  OP_EQUAL, OP_GREATER, OP_LESS,
+  OP_ADD, OP_SUBTRACT, OP_MULTIPLY, OP_DIVIDE,
+  OP_NOT, OP_NEGATE,
+
+  // Lists and maps. OP_LIST and OP_MAP take a two byte element or entry count.
+  OP_LIST, OP_MAP, OP_GET_INDEX, OP_SET_INDEX,
+
+  // Statements and control flow. OP_TAIL_CALL is always followed by an
+  // OP_RETURN, which only runs when the callee turned out to be a native.
+  OP_PRINT, OP_JUMP, OP_JUMP_IF_FALSE, OP_LOOP,
+  OP_CALL, OP_TAIL_CALL, OP_CLOSURE, OP_CLOSE_UPVALUE, OP_RETURN
+};
+
+class VmFunction;
+
+// A compiled sequence of instructions together with the constants it refers
+// to and the source line of every byte, used for runtime error reporting.
+class Chunk {
+    public:
+        std::vector<uint8_t> code;
+        std::vector<int> lines;
+        std::vector<Value> constants;
+        std::vector<VmFunction*> functions;
+
+        void write(uint8_t byte, int line) {
+            code.push_back(byte);
+            lines.push_back(line);
+        }
+
+        int addConstant(Value value) {
+            constants.push_back(value);
+            return constants.size() - 1;
+        }
+
+        int addFunction(VmFunction* function) {
+            functions.push_back(function);
+            return functions.size() - 1;
+        }
+};
+
+// Compiled form of a function declaration (or of the top level script).
+class VmFunction {
+    public:
+        std::string name;
+        int arity;
+        int upvalueCount;
+        Chunk chunk;
+
+        VmFunction(std::string name) {
+            this->name = name;
+            this->arity = 0;
+            this->upvalueCount = 0;
+        }
+
+        // nested functions belong to the chunk that creates their closures
+        ~VmFunction() {
+            for (VmFunction* function : chunk.functions) {
+                delete function;
+            }
+        }
+};
+
+#endif
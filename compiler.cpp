@@ -0,0 +1,509 @@
+#include <vector>
+#include <string>
+
+#include "compiler.h"
+#include "vm.h"
+
+Compiler::Compiler(VM* vm, ErrorReporter* errors) {
+    this->vm = vm;
+    this->errors = errors;
+    this->current = nullptr;
+    this->line = 1;
+    this->hadError = false;
+}
+
+VmFunction* Compiler::compile(std::vector<Stmt<Value>*> statements) {
+    VmFunction* script = new VmFunction("script");
+    FunctionState state(script, nullptr);
+    this->current = &state;
+
+    compileStatements(statements);
+    emitByte(OP_NIL);
+    emitByte(OP_RETURN);
+
+    this->current = nullptr;
+    if (hadError) {
+        delete script;
+        return nullptr;
+    }
+    return script;
+}
+
+Chunk* Compiler::currentChunk() {
+    return &current->function->chunk;
+}
+
+void Compiler::error(Token* token, std::string message) {
+    errors->error(token, message);
+    hadError = true;
+}
+
+void Compiler::compile(Stmt<Value>* stmt) {
+    stmt->accept(this);
+}
+
+void Compiler::compile(Expr<Value>* expr) {
+    expr->accept(this);
+}
+
+void Compiler::compileStatements(std::vector<Stmt<Value>*>& statements) {
+    for (Stmt<Value>* stmt : statements) {
+        compile(stmt);
+    }
+}
+
+void Compiler::emitByte(uint8_t byte) {
+    currentChunk()->write(byte, line);
+}
+
+void Compiler::emitBytes(uint8_t first, uint8_t second) {
+    emitByte(first);
+    emitByte(second);
+}
+
+void Compiler::emitShort(int value) {
+    emitByte((value >> 8) & 0xff);
+    emitByte(value & 0xff);
+}
+
+void Compiler::emitConstant(Value value) {
+    int index = currentChunk()->addConstant(value);
+    if (index > UINT16_MAX) {
+        errors->error(line, "Too many constants in one chunk.");
+        hadError = true;
+        return;
+    }
+    emitByte(OP_CONSTANT);
+    emitShort(index);
+}
+
+void Compiler::emitGlobal(uint8_t instruction, Token* name) {
+    int slot = vm->globalSlot(std::string(name->getLexeme()));
+    if (slot > UINT16_MAX) {
+        error(name, "Too many global variables.");
+        return;
+    }
+    emitByte(instruction);
+    emitShort(slot);
+}
+
+int Compiler::emitJump(uint8_t instruction) {
+    emitByte(instruction);
+    emitShort(0xffff);
+    return currentChunk()->code.size() - 2;
+}
+
+void Compiler::patchJump(int offset) {
+    // -2 to adjust for the jump offset itself
+    int jump = currentChunk()->code.size() - offset - 2;
+    if (jump > UINT16_MAX) {
+        errors->error(line, "Too much code to jump over.");
+        hadError = true;
+    }
+    currentChunk()->code[offset] = (jump >> 8) & 0xff;
+    currentChunk()->code[offset + 1] = jump & 0xff;
+}
+
+void Compiler::emitLoop(int loopStart) {
+    emitByte(OP_LOOP);
+    int offset = currentChunk()->code.size() - loopStart + 2;
+    if (offset > UINT16_MAX) {
+        errors->error(line, "Loop body too large.");
+        hadError = true;
+    }
+    emitShort(offset);
+}
+
+void Compiler::beginScope() {
+    current->scopeDepth++;
+}
+
+void Compiler::endScope() {
+    current->scopeDepth--;
+    std::vector<Local>& locals = current->locals;
+    while (!locals.empty() && locals.back().depth > current->scopeDepth) {
+        if (locals.back().isCaptured) {
+            emitByte(OP_CLOSE_UPVALUE);
+        }
+        else {
+            emitByte(OP_POP);
+        }
+        locals.pop_back();
+    }
+}
+
+void Compiler::declareLocal(Token* name) {
+    if (current->locals.size() > UINT8_MAX) {
+        error(name, "Too many local variables in function.");
+        return;
+    }
+    current->locals.push_back(Local(name->getLexeme(), current->scopeDepth));
+}
+
+int Compiler::resolveLocal(FunctionState* state, Token* name) {
+    for (int i = state->locals.size() - 1; i >= 0; i--) {
+        if (state->locals[i].name == name->getLexeme()) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int Compiler::addUpvalue(FunctionState* state, uint8_t index, bool isLocal, Token* name) {
+    for (int i = 0; i < (int) state->upvalues.size(); i++) {
+        UpvalueRef& upvalue = state->upvalues[i];
+        if (upvalue.index == index && upvalue.isLocal == isLocal) {
+            return i;
+        }
+    }
+    if (state->upvalues.size() > UINT8_MAX) {
+        error(name, "Too many closure variables in function.");
+        return 0;
+    }
+    state->upvalues.push_back(UpvalueRef(index, isLocal));
+    state->function->upvalueCount = state->upvalues.size();
+    return state->upvalues.size() - 1;
+}
+
+int Compiler::resolveUpvalue(FunctionState* state, Token* name) {
+    if (state->enclosing == nullptr) {
+        return -1;
+    }
+    int local = resolveLocal(state->enclosing, name);
+    if (local != -1) {
+        state->enclosing->locals[local].isCaptured = true;
+        return addUpvalue(state, (uint8_t) local, true, name);
+    }
+    int upvalue = resolveUpvalue(state->enclosing, name);
+    if (upvalue != -1) {
+        return addUpvalue(state, (uint8_t) upvalue, false, name);
+    }
+    return -1;
+}
+
+void Compiler::emitGet(Token* name) {
+    int slot = resolveLocal(current, name);
+    if (slot != -1) {
+        emitBytes(OP_GET_LOCAL, slot);
+        return;
+    }
+    slot = resolveUpvalue(current, name);
+    if (slot != -1) {
+        emitBytes(OP_GET_UPVALUE, slot);
+        return;
+    }
+    emitGlobal(OP_GET_GLOBAL, name);
+}
+
+void Compiler::emitSet(Token* name) {
+    int slot = resolveLocal(current, name);
+    if (slot != -1) {
+        emitBytes(OP_SET_LOCAL, slot);
+        return;
+    }
+    slot = resolveUpvalue(current, name);
+    if (slot != -1) {
+        emitBytes(OP_SET_UPVALUE, slot);
+        return;
+    }
+    emitGlobal(OP_SET_GLOBAL, name);
+}
+
+// Called once the value of a declaration is on top of the stack. Locals just
+// leave it there, its stack slot is the variable.
+void Compiler::defineVariable(Token* name) {
+    if (current->scopeDepth > 0) {
+        declareLocal(name);
+        return;
+    }
+    emitGlobal(OP_DEFINE_GLOBAL, name);
+}
+
+void Compiler::compileFunction(Function<Value>* stmt) {
+    VmFunction* function = new VmFunction(std::string(stmt->name->getLexeme()));
+    function->arity = stmt->params.size();
+    FunctionState state(function, current);
+    this->current = &state;
+
+    for (Token* param : stmt->params) {
+        declareLocal(param);
+    }
+    compileStatements(stmt->body);
+    emitByte(OP_NIL);
+    emitByte(OP_RETURN);
+
+    this->current = state.enclosing;
+    int index = currentChunk()->addFunction(function);
+    if (index > UINT16_MAX) {
+        error(stmt->name, "Too many functions in one chunk.");
+        return;
+    }
+    emitByte(OP_CLOSURE);
+    emitShort(index);
+    for (UpvalueRef& upvalue : state.upvalues) {
+        emitByte(upvalue.isLocal ? 1 : 0);
+        emitByte(upvalue.index);
+    }
+}
+
+
+//Assign expressions
+Value Compiler::visitAssignExpr(Assign<Value>* expr) {
+    compile(expr->value);
+    line = expr->name->getLine();
+    emitSet(expr->name);
+    return nullptr;
+}
+
+//Call expressions
+Value Compiler::visitCallExpr(Call<Value>* expr) {
+    compile(expr->callee);
+    for (Expr<Value>* argument : expr->arguments) {
+        compile(argument);
+    }
+    line = expr->paren->getLine();
+    emitBytes(expr->tail ? OP_TAIL_CALL : OP_CALL, expr->arguments.size());
+    return nullptr;
+}
+
+//Binary expressions
+Value Compiler::visitBinaryExpr(Binary<Value>* expr) {
+    compile(expr->left);
+    compile(expr->right);
+    line = expr->operation->getLine();
+    switch (expr->operation->getType()) {
+        case BANG_EQUAL:    emitBytes(OP_EQUAL, OP_NOT); break;
+        case EQUAL_EQUAL:   emitByte(OP_EQUAL); break;
+        case GREATER:       emitByte(OP_GREATER); break;
+        case GREATER_EQUAL: emitBytes(OP_LESS, OP_NOT); break;
+        case LESS:          emitByte(OP_LESS); break;
+        case LESS_EQUAL:    emitBytes(OP_GREATER, OP_NOT); break;
+        case PLUS:          emitByte(OP_ADD); break;
+        case MINUS:         emitByte(OP_SUBTRACT); break;
+        case STAR:          emitByte(OP_MULTIPLY); break;
+        case SLASH:         emitByte(OP_DIVIDE); break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// Fused nodes exist for the interpreter; bytecode is made from the tree they
+// replaced.
+Value Compiler::visitCompareExpr(Compare<Value>* expr) {
+    compile(expr->original);
+    return nullptr;
+}
+
+Value Compiler::visitIncrementExpr(Increment<Value>* expr) {
+    compile(expr->original);
+    return nullptr;
+}
+
+//Grouping expressions
+Value Compiler::visitGroupingExpr(Grouping<Value>* expr) {
+    compile(expr->expression);
+    return nullptr;
+}
+
+//Index expressions
+Value Compiler::visitIndexExpr(Index<Value>* expr) {
+    compile(expr->object);
+    compile(expr->index);
+    line = expr->bracket->getLine();
+    emitByte(OP_GET_INDEX);
+    return nullptr;
+}
+
+//List literals
+Value Compiler::visitListExpr(List<Value>* expr) {
+    for (Expr<Value>* element : expr->elements) {
+        compile(element);
+    }
+    line = expr->bracket->getLine();
+    if (expr->elements.size() > UINT16_MAX) {
+        errors->error(line, "Too many elements in one list literal.");
+        hadError = true;
+        return nullptr;
+    }
+    emitByte(OP_LIST);
+    emitShort(expr->elements.size());
+    return nullptr;
+}
+
+//Literal expressions
+Value Compiler::visitLiteralExpr(Literal<Value>* expr) {
+    if (expr->value.isNil()) {
+        emitByte(OP_NIL);
+    }
+    else if (expr->value.isBool()) {
+        emitByte(expr->value.asBool() ? OP_TRUE : OP_FALSE);
+    }
+    else {
+        emitConstant(expr->value);
+    }
+    return nullptr;
+}
+
+//Logical expressions
+Value Compiler::visitLogicalExpr(Logical<Value>* expr) {
+    compile(expr->left);
+    if (expr->operation->getType() == OR) {
+        int elseJump = emitJump(OP_JUMP_IF_FALSE);
+        int endJump = emitJump(OP_JUMP);
+        patchJump(elseJump);
+        emitByte(OP_POP);
+        compile(expr->right);
+        patchJump(endJump);
+    }
+    else {
+        int endJump = emitJump(OP_JUMP_IF_FALSE);
+        emitByte(OP_POP);
+        compile(expr->right);
+        patchJump(endJump);
+    }
+    return nullptr;
+}
+
+//Index assignments
+Value Compiler::visitSetIndexExpr(SetIndex<Value>* expr) {
+    compile(expr->object);
+    compile(expr->index);
+    compile(expr->value);
+    line = expr->bracket->getLine();
+    emitByte(OP_SET_INDEX);
+    return nullptr;
+}
+
+//Map literals
+Value Compiler::visitMapExpr(Map<Value>* expr) {
+    for (size_t i = 0; i < expr->keys.size(); i++) {
+        compile(expr->keys[i]);
+        compile(expr->values[i]);
+    }
+    line = expr->brace->getLine();
+    if (expr->keys.size() > UINT16_MAX) {
+        errors->error(line, "Too many entries in one map literal.");
+        hadError = true;
+        return nullptr;
+    }
+    emitByte(OP_MAP);
+    emitShort(expr->keys.size());
+    return nullptr;
+}
+
+//Unary expressions
+Value Compiler::visitUnaryExpr(Unary<Value>* expr) {
+    compile(expr->right);
+    line = expr->operation->getLine();
+    switch (expr->operation->getType()) {
+        case BANG:  emitByte(OP_NOT); break;
+        case MINUS: emitByte(OP_NEGATE); break;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+//Variable expressions
+Value Compiler::visitVariableExpr(Variable<Value>* expr) {
+    line = expr->name->getLine();
+    emitGet(expr->name);
+    return nullptr;
+}
+
+//Block statements
+Value Compiler::visitBlockStmt(Block<Value>* stmt) {
+    beginScope();
+    compileStatements(stmt->statements);
+    endScope();
+    return nullptr;
+}
+
+//Expression statements
+Value Compiler::visitExpressionStmt(Expression<Value>* stmt) {
+    compile(stmt->expression);
+    emitByte(OP_POP);
+    return nullptr;
+}
+
+//Function statements
+Value Compiler::visitFunctionStmt(Function<Value>* stmt) {
+    line = stmt->name->getLine();
+    if (current->scopeDepth > 0) {
+        // declared before the body so the function can refer to itself
+        declareLocal(stmt->name);
+        compileFunction(stmt);
+        return nullptr;
+    }
+    compileFunction(stmt);
+    defineVariable(stmt->name);
+    return nullptr;
+}
+
+//If statements
+Value Compiler::visitIfStmt(If<Value>* stmt) {
+    compile(stmt->condition);
+    int thenJump = emitJump(OP_JUMP_IF_FALSE);
+    emitByte(OP_POP);
+    compile(stmt->thenBranch);
+    int elseJump = emitJump(OP_JUMP);
+    patchJump(thenJump);
+    emitByte(OP_POP);
+    if (stmt->elseBranch != nullptr) {
+        compile(stmt->elseBranch);
+    }
+    patchJump(elseJump);
+    return nullptr;
+}
+
+//Print statements
+Value Compiler::visitPrintStmt(Print<Value>* stmt) {
+    compile(stmt->expression);
+    emitByte(OP_PRINT);
+    return nullptr;
+}
+
+//Return statements
+Value Compiler::visitReturnStmt(Return<Value>* stmt) {
+    line = stmt->keyword->getLine();
+    if (stmt->value != nullptr) {
+        compile(stmt->value);
+    }
+    else {
+        emitByte(OP_NIL);
+    }
+    emitByte(OP_RETURN);
+    return nullptr;
+}
+
+//Var statements
+Value Compiler::visitVarStmt(Var<Value>* stmt) {
+    if (stmt->initializer != nullptr) {
+        compile(stmt->initializer);
+    }
+    else {
+        emitByte(OP_NIL);
+    }
+    line = stmt->name->getLine();
+    defineVariable(stmt->name);
+    return nullptr;
+}
+
+Value Compiler::visitVarLiteralStmt(VarLiteral<Value>* stmt) {
+    compile(stmt->original);
+    return nullptr;
+}
+
+//While statements
+Value Compiler::visitWhileStmt(While<Value>* stmt) {
+    int loopStart = currentChunk()->code.size();
+    compile(stmt->condition);
+    int exitJump = emitJump(OP_JUMP_IF_FALSE);
+    emitByte(OP_POP);
+    compile(stmt->body);
+    emitLoop(loopStart);
+    patchJump(exitJump);
+    emitByte(OP_POP);
+    return nullptr;
+}
@@ -0,0 +1,127 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+#include "value.h"
+#include "expr.h"
+#include "stmt.h"
+#include "token.h"
+#include "chunk.h"
+#include "error_reporter.h"
+
+class VM;
+
+// Single pass over the AST that emits bytecode for the VM. Locals live in
+// stack slots, variables captured by closures are reached through upvalues
+// and globals are turned into indices into the VM's global table.
+class Compiler : public Expr<Value>::Visitor<Value>, public Stmt<Value>::Visitor<Value> {
+    private:
+        class Local {
+            public:
+                std::string_view name;
+                int depth;
+                bool isCaptured;
+                Local(std::string_view name, int depth) {
+                    this->name = name;
+                    this->depth = depth;
+                    this->isCaptured = false;
+                }
+        };
+
+        class UpvalueRef {
+            public:
+                uint8_t index;
+                bool isLocal;
+                UpvalueRef(uint8_t index, bool isLocal) {
+                    this->index = index;
+                    this->isLocal = isLocal;
+                }
+        };
+
+        // Compilation state of the function currently being compiled.
+        class FunctionState {
+            public:
+                VmFunction* function;
+                FunctionState* enclosing;
+                std::vector<Local> locals;
+                std::vector<UpvalueRef> upvalues;
+                int scopeDepth;
+                FunctionState(VmFunction* function, FunctionState* enclosing) {
+                    this->function = function;
+                    this->enclosing = enclosing;
+                    this->scopeDepth = enclosing == nullptr ? 0 : enclosing->scopeDepth + 1;
+                    // slot zero holds the function being called
+                    this->locals.push_back(Local("", 0));
+                }
+        };
+
+        VM* vm;
+        ErrorReporter* errors;
+        FunctionState* current;
+        int line;
+        bool hadError;
+
+        Chunk* currentChunk();
+        void error(Token* token, std::string message);
+
+        void compile(Stmt<Value>* stmt);
+        void compile(Expr<Value>* expr);
+        void compileStatements(std::vector<Stmt<Value>*>& statements);
+        void compileFunction(Function<Value>* stmt);
+
+        void emitByte(uint8_t byte);
+        void emitBytes(uint8_t first, uint8_t second);
+        void emitShort(int value);
+        void emitConstant(Value value);
+        // a global's instruction followed by its slot
+        void emitGlobal(uint8_t instruction, Token* name);
+        int emitJump(uint8_t instruction);
+        void patchJump(int offset);
+        void emitLoop(int loopStart);
+
+        void beginScope();
+        void endScope();
+        void declareLocal(Token* name);
+        int resolveLocal(FunctionState* state, Token* name);
+        int addUpvalue(FunctionState* state, uint8_t index, bool isLocal, Token* name);
+        int resolveUpvalue(FunctionState* state, Token* name);
+        void emitGet(Token* name);
+        void emitSet(Token* name);
+        void defineVariable(Token* name);
+
+    public:
+        Compiler(VM* vm, ErrorReporter* errors);
+
+        VmFunction* compile(std::vector<Stmt<Value>*> statements);
+
+        Value visitAssignExpr(Assign<Value>* expr);
+        Value visitCallExpr(Call<Value>* expr);
+        Value visitBinaryExpr(Binary<Value>* expr);
+        Value visitCompareExpr(Compare<Value>* expr);
+        Value visitGroupingExpr(Grouping<Value>* expr);
+        Value visitIncrementExpr(Increment<Value>* expr);
+        Value visitIndexExpr(Index<Value>* expr);
+        Value visitListExpr(List<Value>* expr);
+        Value visitLiteralExpr(Literal<Value>* expr);
+        Value visitLogicalExpr(Logical<Value>* expr);
+        Value visitMapExpr(Map<Value>* expr);
+        Value visitSetIndexExpr(SetIndex<Value>* expr);
+        Value visitUnaryExpr(Unary<Value>* expr);
+        Value visitVariableExpr(Variable<Value>* expr);
+
+        Value visitBlockStmt(Block<Value>* stmt);
+        Value visitExpressionStmt(Expression<Value>* stmt);
+        Value visitFunctionStmt(Function<Value>* stmt);
+        Value visitIfStmt(If<Value>* stmt);
+        Value visitPrintStmt(Print<Value>* stmt);
+        Value visitReturnStmt(Return<Value>* stmt);
+        Value visitVarStmt(Var<Value>* stmt);
+        Value visitVarLiteralStmt(VarLiteral<Value>* stmt);
+        Value visitWhileStmt(While<Value>* stmt);
+};
+
+#endif
@@ -2,17 +2,93 @@
 #define ENVIRONMENT_H
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <unordered_map>
-#include <any>
+#include "value.h"
 
+#include "gc.h"
 #include "token.h"
 #include "runtime_error.h"
 
-class Environment {
+// Values of one scope. Most scopes hold only a few variables, and those live
+// inside the Environment itself so entering a block or calling a function
+// costs one allocation; larger scopes such as the globals spill into a heap
+// buffer that grows like a vector.
+class Slots {
     private:
-        unordered_map<std::string, std::any> values;
+        static const size_t INLINE_CAPACITY = 4;
+        Value inlineValues[INLINE_CAPACITY];
+        std::vector<Value> spilled;
+        Value* values;
+        size_t count;
+        size_t capacity;
+
+        void grow() {
+            std::vector<Value> larger(capacity * 2);
+            std::copy(values, values + count, larger.begin());
+            spilled.swap(larger);
+            values = spilled.data();
+            capacity = spilled.size();
+        }
+
+    public:
+        Slots() {
+            values = inlineValues;
+            count = 0;
+            capacity = INLINE_CAPACITY;
+        }
+
+        Slots(const Slots&) = delete;
+        Slots& operator=(const Slots&) = delete;
+
+        void push_back(const Value& value) {
+            if (count == capacity) {
+                grow();
+            }
+            values[count++] = value;
+        }
+
+        Value& operator[](size_t index) {
+            return values[index];
+        }
+
+        size_t size() {
+            return count;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        Value* begin() {
+            return values;
+        }
+
+        Value* end() {
+            return values + count;
+        }
+
+        // bytes held outside the Environment
+        size_t heapBytes() {
+            return spilled.capacity() * sizeof(Value);
+        }
+};
+
+// Variables of one scope, stored in the order they are declared. The resolver
+// hands out the same slot numbers, so a resolved access never looks at the
+// variable's name. Only the global scope keeps a name table, because globals
+// can be referred to before they are declared.
+class Environment : public GcObject {
+    private:
+        Slots slots;
+        std::vector<bool> defined;
+        unordered_map<std::string, int> nameToSlot;
     public:
         Environment* enclosing;
+        // changes whenever slots may have moved; see GlobalCache
+        unsigned int shape = 1;
+
         Environment(){
             enclosing = nullptr;
         }
@@ -21,8 +97,36 @@ class Environment {
             this->enclosing = enclosing;
         }
 
-        void define(std::string name, std::any value) {
-            values[name] = value;
+        // Locals are defined in declaration order, so the next slot is the
+        // one the resolver assigned to this variable.
+        void define(Value value) {
+            slots.push_back(value);
+        }
+
+        // Slot of the global called name. Unknown names get a fresh slot
+        // which stays undefined until a declaration runs.
+        int slotFor(std::string name) {
+            auto found = nameToSlot.find(name);
+            if (found != nameToSlot.end()) {
+                return found->second;
+            }
+            int slot = slots.size();
+            slots.push_back(Value());
+            shape++;
+            defined.push_back(false);
+            nameToSlot[name] = slot;
+            return slot;
+        }
+
+        // forgets every local, for a function call that reuses its frame
+        void clear() {
+            slots.clear();
+        }
+
+        void define(std::string name, Value value) {
+            int slot = slotFor(name);
+            slots[slot] = value;
+            defined[slot] = true;
         }
 
         Environment* ancestor(int distance) {
@@ -33,37 +137,37 @@ class Environment {
             return env;
         }
 
-        std::any getAt(int distance, std::string name) {
-            return ancestor(distance)->values[name];
+        Value& getAt(int distance, int slot) {
+            return ancestor(distance)->slots[slot];
         }
 
-        std::any get(Token* name) {
-            if (values.find(name->getLexeme()) != values.end()) {
-                return values[name->getLexeme()];
-            }
-            if (enclosing != nullptr) {
-                return enclosing->get(name);
-            }
-            throw new RuntimeError(name, "Undefined variable: " + name->getLexeme() + ".");
+        void assignAt(int distance, int slot, const Value& value) {
+            ancestor(distance)->slots[slot] = value;
         }
 
-        void assignAt(int distance, Token* name, std::any value) {
-            ancestor(distance)->values[name->getLexeme()] = value;
+        Value& get(int slot, Token* name) {
+            if (!defined[slot]) {
+                throw new RuntimeError(name, "Undefined variable: " + std::string(name->getLexeme()) + ".");
+            }
+            return slots[slot];
         }
 
-        void assign(Token* name, std::any value) {
-            if (values.find(name->getLexeme()) != values.end()) {
-                values[name->getLexeme()] = value;
-                return;
+        void assign(int slot, Token* name, const Value& value) {
+            if (!defined[slot]) {
+                throw new RuntimeError(name, "Undefined variable: " + std::string(name->getLexeme()) + ".");
             }
+            slots[slot] = value;
+        }
 
-            if (enclosing != nullptr) {
-                enclosing->assign(name, value);
-                return;
+        void trace(GarbageCollector* gc) {
+            gc->markObject(enclosing);
+            for (Value& value : slots) {
+                gc->markValue(value);
             }
+        }
 
-            throw new RuntimeError(name, "Undefined variable: " + name->getLexeme() + ".");
-
+        size_t size() {
+            return sizeof(Environment) + slots.heapBytes();
         }
 
         ~Environment() = default;
@@ -0,0 +1,59 @@
+#include "error_reporter.h"
+
+ErrorReporter::ErrorReporter() {
+    this->out = &std::cerr;
+    this->hadError = false;
+    this->hadRuntimeError = false;
+}
+
+void ErrorReporter::reset() {
+    hadError = false;
+    hadRuntimeError = false;
+}
+
+void ErrorReporter::report(int line, std::string where, std::string message) {
+    *out << "[line " << line << "] Error" << where << ": " << message << std::endl;
+    hadError = true;
+}
+
+void ErrorReporter::error(Token* token, std::string message){
+    if (token->getType() == END_OF_FILE){
+        report(token->getLine(), " at end ",  message);
+    }
+    else {
+        report(token->getLine(), " at \'" + std::string(token->getLexeme()) + "\'", message);
+    }
+}
+
+void ErrorReporter::error(int line, std::string message){
+    report(line, "", message);
+}
+
+void ErrorReporter::runtimeError(RuntimeError* error) {
+    *out << error->what() << std::endl;
+    *out << "[line " << error->line << "]" << std::endl;
+    *out << error->trace;
+    hadRuntimeError = true;
+}
+
+std::string ErrorReporter::stackTrace(const std::vector<ProfileFrame>& calls, int line) {
+    // recursion that overflows repeats the same few frames thousands of
+    // times, so only both ends of a deep stack are shown
+    static const size_t SHOWN_INNERMOST = 10;
+    static const size_t SHOWN_OUTERMOST = 5;
+    std::string trace;
+    size_t depth = calls.size();
+    for (size_t i = depth; i-- > 0;) {
+        size_t fromTop = depth - 1 - i;
+        if (fromTop == SHOWN_INNERMOST && depth > SHOWN_INNERMOST + SHOWN_OUTERMOST) {
+            size_t skipped = depth - SHOWN_INNERMOST - SHOWN_OUTERMOST;
+            trace += "...  " + std::to_string(skipped) + " more calls\n";
+            i = SHOWN_OUTERMOST;
+            continue;
+        }
+        int frameLine = fromTop == 0 ? line : calls[i].line;
+        std::string where = i == 0 ? "script" : std::string(calls[i].name) + "()";
+        trace += "[line " + std::to_string(frameLine) + "] in " + where + "\n";
+    }
+    return trace;
+}
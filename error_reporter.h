@@ -0,0 +1,41 @@
+#ifndef ERROR_REPORTER_H
+#define ERROR_REPORTER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "token.h"
+#include "runtime_error.h"
+#include "profiler.h"
+
+// Where the scanner, parser, resolver, compiler and either engine report
+// errors, and whether any were reported. Every session has its own, so
+// sessions running on different threads never see each other's errors.
+class ErrorReporter {
+    public:
+        // std::cerr unless the session's host redirects it
+        std::ostream* out;
+        bool hadError;
+        bool hadRuntimeError;
+
+        ErrorReporter();
+
+        // forgets earlier errors, before the next source runs
+        void reset();
+
+        void report(int line, std::string where, std::string message);
+
+        void error(Token* token, std::string message);
+
+        void error(int line, std::string message);
+
+        void runtimeError(RuntimeError* error);
+
+        // The calls in progress, given outermost (the script) first, as a
+        // trace with the innermost first: "[line 3] in fib()". line is where
+        // the innermost call had got to.
+        static std::string stackTrace(const std::vector<ProfileFrame>& calls, int line);
+};
+
+#endif
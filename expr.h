@@ -2,16 +2,24 @@
 #define EXPR_H
 #include <vector>
 #include <string>
-#include <any>
+#include "value.h"
 #include "token.h"
+#include "slot.h"
+#include "inline_cache.h"
 using namespace std;
 
 template <typename R> class Assign;
 template <typename R> class Binary;
 template <typename R> class Call;
+template <typename R> class Compare;
 template <typename R> class Grouping;
+template <typename R> class Increment;
+template <typename R> class Index;
+template <typename R> class List;
 template <typename R> class Literal;
 template <typename R> class Logical;
+template <typename R> class Map;
+template <typename R> class SetIndex;
 template <typename R> class Unary;
 template <typename R> class Variable;
 
@@ -24,9 +32,15 @@ public:
         virtual T visitAssignExpr (Assign<R>* expr) = 0;
         virtual T visitBinaryExpr (Binary<R>* expr) = 0;
         virtual T visitCallExpr (Call<R>* expr) = 0;
+        virtual T visitCompareExpr (Compare<R>* expr) = 0;
         virtual T visitGroupingExpr (Grouping<R>* expr) = 0;
+        virtual T visitIncrementExpr (Increment<R>* expr) = 0;
+        virtual T visitIndexExpr (Index<R>* expr) = 0;
+        virtual T visitListExpr (List<R>* expr) = 0;
         virtual T visitLiteralExpr (Literal<R>* expr) = 0;
         virtual T visitLogicalExpr (Logical<R>* expr) = 0;
+        virtual T visitMapExpr (Map<R>* expr) = 0;
+        virtual T visitSetIndexExpr (SetIndex<R>* expr) = 0;
         virtual T visitUnaryExpr (Unary<R>* expr) = 0;
         virtual T visitVariableExpr (Variable<R>* expr) = 0;
         virtual ~Visitor() = default;
@@ -41,6 +55,8 @@ class Assign : public Expr<R> {
 public:
     Token* name;
     Expr<R>* value;
+    Slot slot;
+    GlobalCache cache;
     Assign(Token* name, Expr<R>* value) {
         this->name=name;
         this->value=value;
@@ -56,6 +72,7 @@ public:
     Expr<R>* left;
     Token* operation;
     Expr<R>* right;
+    QuickBinary quick = QUICK_NONE;
     Binary(Expr<R>* left, Token* operation, Expr<R>* right) {
         this->left=left;
         this->operation=operation;
@@ -72,6 +89,7 @@ public:
     Expr<R>* callee;
     Token* paren;
     vector<Expr<R>*> arguments;
+    bool tail = false;
     Call(Expr<R>* callee, Token* paren, vector<Expr<R>*> arguments) {
         this->callee=callee;
         this->paren=paren;
@@ -82,6 +100,26 @@ public:
     }
 };
 
+template <typename R>
+class Compare : public Expr<R> {
+public:
+    Expr<R>* original;
+    Variable<R>* left;
+    Token* operation;
+    Variable<R>* right;
+    Value constant;
+    Compare(Expr<R>* original, Variable<R>* left, Token* operation, Variable<R>* right, Value constant) {
+        this->original=original;
+        this->left=left;
+        this->operation=operation;
+        this->right=right;
+        this->constant=constant;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitCompareExpr(this);
+    }
+};
+
 template <typename R>
 class Grouping : public Expr<R> {
 public:
@@ -94,11 +132,61 @@ public:
     }
 };
 
+template <typename R>
+class Increment : public Expr<R> {
+public:
+    Expr<R>* original;
+    Token* name;
+    Token* operation;
+    double amount;
+    Slot slot;
+    GlobalCache cache;
+    Increment(Expr<R>* original, Token* name, Token* operation, double amount) {
+        this->original=original;
+        this->name=name;
+        this->operation=operation;
+        this->amount=amount;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitIncrementExpr(this);
+    }
+};
+
+template <typename R>
+class Index : public Expr<R> {
+public:
+    Expr<R>* object;
+    Token* bracket;
+    Expr<R>* index;
+    Index(Expr<R>* object, Token* bracket, Expr<R>* index) {
+        this->object=object;
+        this->bracket=bracket;
+        this->index=index;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitIndexExpr(this);
+    }
+};
+
+template <typename R>
+class List : public Expr<R> {
+public:
+    Token* bracket;
+    vector<Expr<R>*> elements;
+    List(Token* bracket, vector<Expr<R>*> elements) {
+        this->bracket=bracket;
+        this->elements=elements;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitListExpr(this);
+    }
+};
+
 template <typename R>
 class Literal : public Expr<R> {
 public:
-    any value;
-    Literal(any value) {
+    Value value;
+    Literal(Value value) {
         this->value=value;
     }
     R accept(typename Expr<R>::template Visitor<R>* visitor) override {
@@ -122,6 +210,40 @@ public:
     }
 };
 
+template <typename R>
+class Map : public Expr<R> {
+public:
+    Token* brace;
+    vector<Expr<R>*> keys;
+    vector<Expr<R>*> values;
+    Map(Token* brace, vector<Expr<R>*> keys, vector<Expr<R>*> values) {
+        this->brace=brace;
+        this->keys=keys;
+        this->values=values;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitMapExpr(this);
+    }
+};
+
+template <typename R>
+class SetIndex : public Expr<R> {
+public:
+    Expr<R>* object;
+    Token* bracket;
+    Expr<R>* index;
+    Expr<R>* value;
+    SetIndex(Expr<R>* object, Token* bracket, Expr<R>* index, Expr<R>* value) {
+        this->object=object;
+        this->bracket=bracket;
+        this->index=index;
+        this->value=value;
+    }
+    R accept(typename Expr<R>::template Visitor<R>* visitor) override {
+        return visitor->visitSetIndexExpr(this);
+    }
+};
+
 template <typename R>
 class Unary : public Expr<R> {
 public:
@@ -140,6 +262,8 @@ template <typename R>
 class Variable : public Expr<R> {
 public:
     Token* name;
+    Slot slot;
+    GlobalCache cache;
     Variable(Token* name) {
         this->name=name;
     }
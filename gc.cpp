@@ -0,0 +1,206 @@
+#include <chrono>
+#include <algorithm>
+
+#include "gc.h"
+#include "icarus_callable.h"
+
+GarbageCollector::GarbageCollector() {
+    this->objects = nullptr;
+    this->heapBytes = 0;
+    this->nextCollection = INITIAL_THRESHOLD;
+}
+
+GarbageCollector::~GarbageCollector() {
+    GcObject* object = objects;
+    while (object != nullptr) {
+        GcObject* next = object->nextObject;
+        delete object;
+        object = next;
+    }
+}
+
+void GarbageCollector::track(GcObject* object) {
+    object->nextObject = objects;
+    objects = object;
+    size_t size = object->size();
+    object->trackedBytes = size;
+    heapBytes += size;
+    stats.bytesAllocated += size;
+    stats.heapBytes = heapBytes;
+}
+
+void GarbageCollector::account(GcObject* object, size_t size) {
+    heapBytes += size - object->trackedBytes;
+    stats.bytesAllocated += size - object->trackedBytes;
+    stats.heapBytes = heapBytes;
+    object->trackedBytes = size;
+#ifdef DEBUG_STRESS_GC
+    collect();
+#else
+    if (heapBytes > nextCollection) {
+        collect();
+    }
+#endif
+}
+
+IcarusString* GarbageCollector::newString(std::string chars) {
+    return allocate<IcarusString>(chars);
+}
+
+IcarusString* GarbageCollector::newPermanentString(std::string chars) {
+    auto existing = interned.find(chars);
+    if (existing != interned.end()) {
+        return existing->second;
+    }
+    IcarusString* string = allocate<IcarusString>(std::move(chars));
+    string->permanent = true;
+    string->interned = true;
+    interned.emplace(string->str(), string);
+    return string;
+}
+
+void GarbageCollector::forgetLiterals() {
+    for (auto& entry : interned) {
+        entry.second->permanent = false;
+        entry.second->interned = false;
+    }
+    interned.clear();
+}
+
+// Below this many characters copying is cheaper than another object and
+// the pointer chasing it costs every reader.
+static const size_t ROPE_THRESHOLD = 256;
+
+IcarusString* GarbageCollector::concatenate(IcarusString* a, IcarusString* b) {
+    if (a->length() + b->length() < ROPE_THRESHOLD) {
+        return newString(a->str() + b->str());
+    }
+    // the caller may already have popped both operands
+    pinned.push_back(a);
+    pinned.push_back(b);
+    IcarusString* rope = allocate<IcarusString>(a, b);
+    pinned.resize(pinned.size() - 2);
+    return rope;
+}
+
+void GarbageCollector::addRoots(GcRoots* source) {
+    roots.push_back(source);
+}
+
+void GarbageCollector::removeRoots(GcRoots* source) {
+    roots.erase(std::remove(roots.begin(), roots.end(), source), roots.end());
+}
+
+void GarbageCollector::markObject(GcObject* object) {
+    if (object == nullptr || object->marked) {
+        return;
+    }
+    object->marked = true;
+    grayStack.push_back(object);
+}
+
+void GarbageCollector::markValue(const Value& value) {
+    if (value.isString()) {
+        markObject(value.asStringObject());
+    }
+    else if (value.isCallable()) {
+        markObject(value.asCallable());
+    }
+    else if (value.isList()) {
+        markObject(value.asList());
+    }
+    else if (value.isMap()) {
+        markObject(value.asMap());
+    }
+}
+
+void IcarusList::trace(GarbageCollector* gc) {
+    for (Value& element : elements) {
+        gc->markValue(element);
+    }
+}
+
+void IcarusString::trace(GarbageCollector* gc) {
+    gc->markObject(left);
+    gc->markObject(right);
+}
+
+void GarbageCollector::markRoots() {
+    for (GcObject* object : pinned) {
+        markObject(object);
+    }
+    for (GcRoots* source : roots) {
+        source->markRoots(this);
+    }
+}
+
+void GarbageCollector::traceReferences() {
+    while (!grayStack.empty()) {
+        GcObject* object = grayStack.back();
+        grayStack.pop_back();
+        object->trace(this);
+    }
+}
+
+void GarbageCollector::sweep() {
+    GcObject* previous = nullptr;
+    GcObject* object = objects;
+    size_t live = 0;
+    while (object != nullptr) {
+        // growth nobody reported through grew(), such as parameters spilling
+        size_t size = object->size();
+        if (size > object->trackedBytes) {
+            stats.bytesAllocated += size - object->trackedBytes;
+            object->trackedBytes = size;
+        }
+
+        if (object->marked || object->permanent) {
+            object->marked = false;
+            live += size;
+            previous = object;
+            object = object->nextObject;
+            continue;
+        }
+
+        GcObject* unreached = object;
+        object = object->nextObject;
+        if (previous == nullptr) {
+            objects = object;
+        }
+        else {
+            previous->nextObject = object;
+        }
+        stats.bytesFreed += size;
+        stats.objectsFreed++;
+        delete unreached;
+    }
+    heapBytes = live;
+}
+
+void GarbageCollector::collect() {
+    auto start = std::chrono::steady_clock::now();
+
+    markRoots();
+    traceReferences();
+    sweep();
+
+    nextCollection = std::max(heapBytes * 2, (size_t) INITIAL_THRESHOLD);
+
+    std::chrono::duration<double, std::milli> pause = std::chrono::steady_clock::now() - start;
+    stats.collections++;
+    stats.heapBytes = heapBytes;
+    stats.lastPauseMs = pause.count();
+    stats.totalPauseMs += pause.count();
+    stats.maxPauseMs = std::max(stats.maxPauseMs, pause.count());
+    if (statsHook) {
+        statsHook(stats);
+    }
+}
+
+const GcStats& GarbageCollector::getStats() {
+    return stats;
+}
+
+void GarbageCollector::setStatsHook(std::function<void(const GcStats&)> hook) {
+    this->statsHook = hook;
+}
@@ -0,0 +1,118 @@
+#ifndef GC_H
+#define GC_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <utility>
+#include <string_view>
+#include <unordered_map>
+#include <cstddef>
+
+#include "object.h"
+#include "value.h"
+
+class GarbageCollector;
+
+// Anything that holds references to collected objects outside the heap
+// (the interpreter's environments and temporaries, the vm's stack) registers
+// itself so the collector can start marking from there.
+class GcRoots {
+    public:
+        virtual void markRoots(GarbageCollector* gc) = 0;
+        virtual ~GcRoots() = default;
+};
+
+class GcStats {
+    public:
+        size_t collections = 0;
+        size_t bytesAllocated = 0;
+        size_t bytesFreed = 0;
+        size_t objectsFreed = 0;
+        size_t heapBytes = 0;
+        double lastPauseMs = 0;
+        double totalPauseMs = 0;
+        double maxPauseMs = 0;
+};
+
+// Tracing mark and sweep collector. Objects are allocated through
+// allocate(), which starts a collection once the heap has grown past a
+// threshold; the threshold is then set to twice the heap that survived.
+class GarbageCollector {
+    private:
+        static const size_t INITIAL_THRESHOLD = 1024 * 1024;
+
+        GcObject* objects;
+        size_t heapBytes;
+        size_t nextCollection;
+        std::vector<GcObject*> grayStack;
+        std::vector<GcRoots*> roots;
+        // one permanent copy of every literal, keyed by its own characters
+        std::unordered_map<std::string_view, IcarusString*> interned;
+        // operands of an allocation in progress, which nothing else may hold
+        std::vector<GcObject*> pinned;
+        GcStats stats;
+        std::function<void(const GcStats&)> statsHook;
+
+        void track(GcObject* object);
+        void account(GcObject* object, size_t size);
+        void markRoots();
+        void traceReferences();
+        void sweep();
+
+    public:
+        GarbageCollector();
+        ~GarbageCollector();
+
+        template <typename T, typename... Args>
+        T* allocate(Args&&... args) {
+#ifdef DEBUG_STRESS_GC
+            collect();
+#else
+            if (heapBytes > nextCollection) {
+                collect();
+            }
+#endif
+            T* object = new T(std::forward<Args>(args)...);
+            track(object);
+            return object;
+        }
+
+        // Charges the heap for an object that has grown since it was
+        // allocated, such as a list pushed onto, and collects if that takes
+        // the heap past the threshold. object must be reachable from a root.
+        void grew(GcObject* object) {
+            size_t size = object->size();
+            if (size > object->trackedBytes) {
+                account(object, size);
+            }
+        }
+
+        IcarusString* newString(std::string chars);
+
+        // strings that live as long as the collector, used for literals;
+        // asking twice for the same text returns the same string
+        IcarusString* newPermanentString(std::string chars);
+
+        // Lets every literal be collected again once nothing refers to it.
+        // Only for when no syntax tree or compiled code will run again.
+        void forgetLiterals();
+
+        // a + b, flat when short and a rope sharing both halves otherwise
+        IcarusString* concatenate(IcarusString* a, IcarusString* b);
+
+        void addRoots(GcRoots* source);
+        void removeRoots(GcRoots* source);
+
+        void markObject(GcObject* object);
+        void markValue(const Value& value);
+
+        void collect();
+
+        const GcStats& getStats();
+
+        // called after every collection with the updated statistics
+        void setStatsHook(std::function<void(const GcStats&)> hook);
+};
+
+#endif
@@ -6,63 +6,76 @@
 #include <string>
 #include <cstdlib>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "icarus.h"
-#include "scanner.h"
 #include "token.h"
-#include "parser.h"
-#include "resolver.h"
-#include "cleaner.h"
 #include "runtime_error.h"
-#include "stmt.h"
-
-
-Interpreter* Icarus::interpreter = new Interpreter(); 
-
-bool Icarus::hadError = false;
-
-bool Icarus::hadRuntimeError = false;
+#include "alloc_stats.h"
 
-void Icarus::run(std::string source){
-    Scanner *scanner = new Scanner(source);
-    std::vector<Token *> tokens = scanner->scanTokens();
-    Parser<std::any>* parser = new Parser<std::any>(tokens);
 
-    std::vector<Stmt<std::any>*> statements = parser->parse();
+Session* Icarus::session = new Session();
 
-    if (hadError) return;
+bool Icarus::gcStats = false;
 
-    Resolver* resolver = new Resolver(interpreter);
-    resolver->resolve(statements);
-    interpreter->interpret(statements);
-    
-    Cleaner* cleaner = new Cleaner();
-    
-    cleaner->clean(statements);
+bool Icarus::cacheStats = false;
 
-    scanner->clean();
+bool Icarus::allocStats = false;
 
-    parser->clean();
-
-    delete parser;
-    delete resolver;
-    delete interpreter;
-    delete cleaner;
+RunResult Icarus::run(std::string_view source){
+    return session->run(source);
+}
 
+// Reads everything from a stream that cannot be mapped, such as a pipe.
+static std::string readStream(std::istream& stream) {
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    return contents.str();
 }
 
 void Icarus::runFile(char *filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        std::cerr << "Unable to open file: " << filename << std::endl;
-        exit(1);
+    RunResult result;
+    // "-" reads the script from stdin
+    if (std::string(filename) == "-") {
+        std::string source = readStream(std::cin);
+        result = run(source);
     }
+    else {
+        int fd = open(filename, O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) < 0) {
+            std::cerr << "Unable to open file: " << filename << std::endl;
+            exit(1);
+        }
 
-    std::vector<char> fileContents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    file.close();
-    std::string fileString(fileContents.begin(), fileContents.end());
-    run(fileString);
-    if (hadError) exit(65);
-    if (hadRuntimeError) exit(70);
+        // Regular files are mapped read-only and scanned in place. Anything
+        // else (fifos, /dev/stdin, empty files) falls back to reading it in.
+        void* mapped = MAP_FAILED;
+        if (S_ISREG(info.st_mode) && info.st_size > 0) {
+            mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        if (mapped != MAP_FAILED) {
+            close(fd);
+            madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+            result = run(std::string_view((const char*) mapped, info.st_size));
+            munmap(mapped, info.st_size);
+        }
+        else {
+            close(fd);
+            std::ifstream file(filename, std::ios::binary);
+            if (!file) {
+                std::cerr << "Unable to open file: " << filename << std::endl;
+                exit(1);
+            }
+            std::string source = readStream(file);
+            result = run(source);
+        }
+    }
+    if (result == RUN_COMPILE_ERROR) exit(65);
+    if (result == RUN_RUNTIME_ERROR) exit(70);
 }
 
 
@@ -74,29 +87,44 @@ void Icarus::runPrompt(){
             break;
         }
         run(line);
-        hadError = false;
     }
 }
 
-void Icarus::report(int line, std::string where, std::string message) {
-    std::cerr << "[line " << line << "] Error" << where << ": " << message << std::endl;
-    hadError = true;
+void Icarus::reportGcStats() {
+    const GcStats& stats = session->gc->getStats();
+    std::cerr << "[gc] " << stats.collections << " collections, "
+              << stats.bytesAllocated << " bytes allocated, "
+              << stats.bytesFreed << " bytes freed (" << stats.objectsFreed << " objects), "
+              << stats.heapBytes << " bytes live, "
+              << "pause total " << stats.totalPauseMs << "ms max " << stats.maxPauseMs << "ms" << std::endl;
 }
 
-void Icarus::error(Token* token, std::string message){
-    if (token->getType() == END_OF_FILE){
-        report(token->getLine(), " at end ",  message);
-    }
-    else {
-        report(token->getLine(), " at \'" + token->getLexeme() + "\'", message);
+void Icarus::reportCacheStats() {
+    const InlineCacheStats& stats = session->interpreter->cacheStats;
+    size_t lookups = stats.hits + stats.misses;
+    std::cerr << "[cache] " << stats.hits << " global hits, " << stats.misses << " misses";
+    if (lookups > 0) {
+        std::cerr << " (" << (100.0 * stats.hits / lookups) << "% hit rate)";
     }
+    std::cerr << std::endl;
+    std::cerr << "[cache] " << stats.quickened << " binary operations quickened, "
+              << stats.deoptimized << " deoptimized" << std::endl;
+}
+
+#ifdef ICARUS_NODE_STATS
+void Icarus::reportNodeStats() {
+    session->interpreter->nodeStats.report(std::cerr, 30);
 }
-void Icarus::error(int line, std::string message){
-    report(line, "", message);
+#endif
+
+void Icarus::reportAllocStats() {
+    std::cerr << "[alloc] " << AllocStats::allocations() << " allocations, "
+              << AllocStats::allocatedBytes() << " bytes" << std::endl;
 }
 
-void Icarus::runtimeError(RuntimeError* error) {
-    std::cerr << error->what() << std::endl;
-    std::cerr << "[line " << error->token->getLine() << + "]" << std::endl;
-    hadRuntimeError = true;
+void Icarus::writeProfile() {
+    Profiler* profiler = session->profiler;
+    profiler->stop();
+    size_t samples = profiler->write();
+    std::cerr << "[profile] " << samples << " samples written to " << profiler->getPath() << std::endl;
 }
@@ -2,30 +2,37 @@
 #define ICARUS_H
 
 #include <string>
-#include "interpreter.h"
-#include "token.h"
-#include "runtime_error.h"
+#include <string_view>
+#include "session.h"
 
+// The command line front end: the one session that scripts given on the
+// command line and REPL lines run in, and the statistics asked for on it.
+// Hosts that run scripts themselves create Sessions of their own, or hand
+// them to a ScriptPool, instead.
 class Icarus {
     public:
-        static Interpreter* interpreter;
-        static bool hadError;
+        static Session* session;
+        static bool gcStats;
+        static bool cacheStats;
+        static bool allocStats;
 
-        static bool hadRuntimeError;
-
-        static void run(std::string source);
+        static RunResult run(std::string_view source);
 
         static void runFile(char *filename);
 
         static void runPrompt();
 
-        static void report(int line, std::string where, std::string message);
+        static void reportGcStats();
+
+        static void reportCacheStats();
 
-        static void error(Token* token, std::string message);
-        
-        static void error(int line, std::string message);
+        static void reportAllocStats();
 
-        static void runtimeError(RuntimeError* error);
+        static void writeProfile();
+
+#ifdef ICARUS_NODE_STATS
+        static void reportNodeStats();
+#endif
 };
 
 #endif
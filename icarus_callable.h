@@ -2,14 +2,20 @@
 #define ICARUS_CALLABLE_H
 
 #include <vector>
-#include <any>
+#include <string_view>
+#include "value.h"
 
+#include "object.h"
 #include "interpreter.h"
 
-class IcarusCallable {
+class IcarusCallable : public GcObject {
     public:
         virtual int arity() = 0;
-        virtual std::any call(Interpreter* interpreter, std::vector<std::any> arguments) = 0;
+        // shown in profiles
+        virtual std::string_view name() = 0;
+        // arguments points at arity() values owned by the caller, which stay
+        // put until the callee runs Lox code of its own
+        virtual Value call(Interpreter* interpreter, const Value* arguments) = 0;
 };
 
 #endif
@@ -2,14 +2,13 @@
 #define ICARUS_FUNCTION_H
 
 #include <vector>
-#include <any>
+#include "value.h"
 #include <iostream>
 
 #include "icarus_callable.h"
 #include "stmt.h"
 #include "interpreter.h"
 #include "env.h"
-#include "stack_unwinder.h"
 
 template <typename R>
 class IcarusFunction : public IcarusCallable {
@@ -26,21 +25,58 @@ class IcarusFunction : public IcarusCallable {
             return this->declaration->params.size();
         }
 
-        std::any call(Interpreter* interpreter, std::vector<std::any> arguments) {
-            Environment* environment = new Environment(this->closure);
-            for (int i = 0; i < this->declaration->params.size(); i++) {
-                environment->define(this->declaration->params[i]->getLexeme(), arguments[i]);
-            }
-            try {
-                interpreter->executeBlock(this->declaration->body, environment);
-            } catch (StackUnwinder* returnValue) {
-                return returnValue->value;
+        std::string_view name() {
+            return this->declaration->name->getLexeme();
+        }
+
+        // Tail calls to Lox functions come back here as a completion rather
+        // than nesting another call, so tail recursion runs in constant C++
+        // stack. A function with no closures inside it calling itself reuses
+        // its environment, since nothing else can still refer to it.
+        //
+        // Only this function and the callee of the latest tail call are
+        // rooted, so the function running may have been collected by the
+        // time it makes its own tail call. Calling itself is therefore told
+        // by the declaration, which lives as long as the tree, and the
+        // enclosing environment, which the running environment keeps alive.
+        Value call(Interpreter* interpreter, const Value* arguments) {
+            Function<R>* running = this->declaration;
+            Environment* environment = interpreter->gc->allocate<Environment>(this->closure);
+            while (true) {
+#ifdef ICARUS_NODE_STATS
+                NodeTimer timer(interpreter->nodeStats.runningFunctions, interpreter->nodeStats.functionStatFor(running));
+#endif
+                for (size_t i = 0; i < running->params.size(); i++) {
+                    environment->define(arguments[i]);
+                }
+                CompletionType completion = interpreter->executeBlock(running->body, environment);
+                if (completion == RETURN_COMPLETION) {
+                    return interpreter->takeReturnValue();
+                }
+                if (completion != TAIL_CALL_COMPLETION) {
+                    return nullptr;
+                }
+
+                const Value* tailCall = interpreter->takeTailCall();
+                IcarusFunction<R>* callee = static_cast<IcarusFunction<R>*>(tailCall[0].asCallable());
+                arguments = tailCall + 1;
+                if (callee->declaration == running && callee->closure == environment->enclosing
+                        && !running->hasClosures) {
+                    environment->clear();
+                }
+                else {
+                    environment = interpreter->gc->allocate<Environment>(callee->closure);
+                }
+                running = callee->declaration;
             }
-            return nullptr;
         }
 
-        std::string toString() {
-            return "<fn " + this->declaration->name->lexeme + ">";
+        void trace(GarbageCollector* gc) {
+            gc->markObject(closure);
+        }
+
+        size_t size() {
+            return sizeof(IcarusFunction<R>);
         }
 };
 
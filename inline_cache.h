@@ -0,0 +1,40 @@
+#ifndef INLINE_CACHE_H
+#define INLINE_CACHE_H
+
+#include <cstddef>
+#include "value.h"
+
+// Remembers where a Variable or Assign node found its global the last time
+// it ran. The cache is valid while the global table keeps the shape it had
+// then; adding a global may move every slot, so it bumps the shape and
+// every cache misses once before refilling.
+class GlobalCache {
+    public:
+        Value* value = nullptr;
+        unsigned int shape = 0;
+};
+
+// What a Binary node settled on the first time it ran: one operation on two
+// numbers, string concatenation, or the generic path that checks the
+// operator and the operand types every time. A specialized node whose
+// operands stop having the types it expects falls back to generic for good.
+enum QuickBinary : unsigned char {
+    QUICK_NONE,
+    QUICK_ADD_NUMBERS, QUICK_SUBTRACT_NUMBERS, QUICK_MULTIPLY_NUMBERS, QUICK_DIVIDE_NUMBERS,
+    QUICK_GREATER_NUMBERS, QUICK_GREATER_EQUAL_NUMBERS, QUICK_LESS_NUMBERS, QUICK_LESS_EQUAL_NUMBERS,
+    QUICK_EQUAL_NUMBERS, QUICK_NOT_EQUAL_NUMBERS,
+    QUICK_CONCATENATE,
+    QUICK_GENERIC
+};
+
+class InlineCacheStats {
+    public:
+        size_t hits = 0;
+        size_t misses = 0;
+        // Binary nodes specialized on their first run, and those of them
+        // that later had to fall back to the generic path
+        size_t quickened = 0;
+        size_t deoptimized = 0;
+};
+
+#endif
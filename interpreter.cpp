@@ -1,4 +1,4 @@
-#include <any>
+#include "value.h"
 #include <stdexcept>
 #include <iostream>
 #include <vector>
@@ -9,215 +9,366 @@
 #include "token.h"
 #include "tokentype.h"
 #include "runtime_error.h"
-#include "icarus.h"
 #include "icarus_callable.h"
 #include "icarus_function.h"
-#include "stack_unwinder.h"
-
-Interpreter::Interpreter() {
-    this->globals = new Environment();
+#include "natives.h"
+
+Interpreter::Interpreter(GarbageCollector* gc, ErrorReporter* errors) {
+    this->gc = gc;
+    this->profiler = nullptr;
+    this->errors = errors;
+    this->out = &std::cout;
+    this->maxDepth = DEFAULT_MAX_DEPTH;
+    this->globals = gc->allocate<Environment>();
     this->env = globals;
+    gc->addRoots(this);
+}
+
+Interpreter::~Interpreter() {
+    gc->removeRoots(this);
 }
 
-std::any Interpreter::evaluate(Expr<std::any>* expr) {
+void Interpreter::markRoots(GarbageCollector* gc) {
+    gc->markObject(globals);
+    gc->markObject(env);
+    for (Environment* environment : envStack) {
+        gc->markObject(environment);
+    }
+    for (Value& value : tempRoots) {
+        gc->markValue(value);
+    }
+    for (Value& value : tailCall) {
+        gc->markValue(value);
+    }
+    gc->markValue(completion.value);
+}
+
+Value Interpreter::evaluate(Expr<Value>* expr) {
+#ifdef ICARUS_NODE_STATS
+    NodeTimer timer(nodeStats.runningNodes, nodeStats.statFor(expr));
+#endif
     return expr->accept(this);
 }
 
-std::any Interpreter::execute(Stmt<std::any>* stmt) {
+CompletionType Interpreter::execute(Stmt<Value>* stmt) {
+#ifdef ICARUS_NODE_STATS
+    NodeTimer timer(nodeStats.runningNodes, nodeStats.statFor(stmt));
+#endif
     stmt->accept(this);
-    return nullptr;
+    return completion.type;
 }
 
-void Interpreter::resolve(Expr<std::any>* expr, int depth) {
-    locals[expr] = depth;
+Value Interpreter::takeReturnValue() {
+    Value value = completion.value;
+    completion = Completion();
+    return value;
 }
 
-std::any Interpreter::lookUpVariable(Token* name, Expr<std::any>* expr) {
-    if (locals.find(expr) != locals.end()) {
-        int distance = locals[expr];
-        return env->getAt(distance, name->getLexeme());
-    }
-    else {
-        return globals->get(name);
-    }
-    
+const Value* Interpreter::takeTailCall() {
+    completion = Completion();
+    return tailCall.data();
 }
 
-bool Interpreter::isEqual(std::any a, std::any b) {
-    if (a.type() == typeid(std::nullptr_t) && b.type() == typeid(std::nullptr_t)) {
-        return true;
-    }
-    if (a.type() == typeid(std::nullptr_t)) {
-        return false;
-    }
-    
-    if (a.type() != b.type()) {
-        return false;
-    }
+int Interpreter::globalSlot(std::string name) {
+    return globals->slotFor(name);
+}
 
-    // check the actual values based on the type
-    if (a.type() == typeid(int)) {
-        return std::any_cast<int>(a) == std::any_cast<int>(b);
-    } else if (a.type() == typeid(double)) {
-        return std::any_cast<double>(a) == std::any_cast<double>(b);
-    } else if (a.type() == typeid(bool)) {
-        return std::any_cast<bool>(a) == std::any_cast<bool>(b);
-    } else if (a.type() == typeid(std::string)) {
-        return std::any_cast<std::string>(a) == std::any_cast<std::string>(b);
+void Interpreter::resetGlobals() {
+    globals = gc->allocate<Environment>();
+    env = globals;
+}
+
+Value& Interpreter::lookUp(Token* name, Slot& slot, GlobalCache& cache) {
+    if (slot.depth >= 0) {
+        return env->getAt(slot.depth, slot.index);
+    }
+    if (cache.shape == globals->shape) {
+        cacheStats.hits++;
+        return *cache.value;
     }
-    return false;
+    cacheStats.misses++;
+    Value& value = globals->get(slot.index, name);
+    cache.value = &value;
+    cache.shape = globals->shape;
+    return value;
 }
 
-bool Interpreter::isTruthy(std::any object) {
-    if (object.type() == typeid(std::nullptr_t)){
-        return false;
+void Interpreter::define(Token* name, const Value& value) {
+    if (env == globals) {
+        globals->define(std::string(name->getLexeme()), value);
     }
-    if (object.type() == typeid(bool)){
-        return std::any_cast<bool>(object);
+    else {
+        env->define(value);
     }
-    return true;
+    gc->grew(env);
+}
 
+void Interpreter::sample(int line) {
+    if (profiler == nullptr) {
+        return;
+    }
+    callStack.back().line = line;
+    profiler->record(callStack);
 }
 
-void Interpreter::checkNumberOperand(Token* operation, std::any operand) {
-    if (operand.type() == typeid(double)) {
+void Interpreter::checkNumberOperand(Token* operation, const Value& operand) {
+    if (operand.isNumber()) {
         return;
     }
     throw new RuntimeError(operation, "Operand must be a number");
 }
 
-void Interpreter::checkNumberOperands(Token* operation, std::any left, std::any right) {
+void Interpreter::checkNumberOperands(Token* operation, const Value& left, const Value& right) {
 
-    if (left.type() == typeid(double) && right.type() == typeid(double)) {
+    if (left.isNumber() && right.isNumber()) {
         return;
     }
     throw new RuntimeError(operation, "Operands must be numbers");
 }
 
 
-std::string Interpreter::stringify(std::any object) {
-    if (object.type() == typeid(nullptr_t)){
-        return "nil";
-    }
-
-    if (object.type() == typeid(double)){
-        double num = std::any_cast<double>(object);
-        std::string text = std::to_string(num);
-        if (text.substr(text.size() - 2, 2) == ".0") {
-            text.erase(text.size() - 2);
-        }
-        return text;
-    }
-
-    else if (object.type() == typeid(std::string)) {
-        return std::any_cast<std::string>(object);
-    }
-
-    else if(object.type() == typeid(bool)) {
-        bool value = std::any_cast<bool>(object);
-        return std::to_string(value);
-    }
-    return "unsupported";
-}
-
-std::any Interpreter::executeBlock(std::vector<Stmt<std::any>*> statements, Environment* environment) {
+CompletionType Interpreter::executeBlock(const std::vector<Stmt<Value>*>& statements, Environment* environment) {
     Environment* previous = this->env;
+    envStack.push_back(previous);
     this->env = environment;
 
-    for (Stmt<std::any>* statement : statements) {
-        execute(statement);
+    try {
+        for (Stmt<Value>* statement : statements) {
+            if (execute(statement) != NORMAL_COMPLETION) {
+                break;
+            }
+        }
+    } catch (...) {
+        this->env = previous;
+        envStack.pop_back();
+        throw;
     }
     this->env = previous;
-    return nullptr;
+    envStack.pop_back();
+    return completion.type;
 }
 
 
 //Assign expressions
-std::any Interpreter::visitAssignExpr(Assign<std::any>* expr) {
-    std::any value = evaluate(expr->value);
-    if (locals.find(expr) != locals.end()) {
-        int distance = locals[expr];
-        env->assignAt(distance, expr->name, value);
+Value Interpreter::visitAssignExpr(Assign<Value>* expr) {
+    Value value = evaluate(expr->value);
+    Slot& slot = expr->slot;
+    if (slot.depth >= 0) {
+        env->assignAt(slot.depth, slot.index, value);
+        return value;
     }
-    else {
-        globals->assign(expr->name, value);
+    GlobalCache& cache = expr->cache;
+    if (cache.shape == globals->shape) {
+        cacheStats.hits++;
+        *cache.value = value;
+        return value;
     }
+    cacheStats.misses++;
+    globals->assign(slot.index, expr->name, value);
+    cache.value = &globals->get(slot.index, expr->name);
+    cache.shape = globals->shape;
     return value;
 }
 
 //Call expressions
-std::any Interpreter::visitCallExpr(Call<std::any>* expr) {
-    std::any callee = evaluate(expr->callee);
-    std::vector<std::any> arguments;
-    for (int i = 0; i < expr->arguments.size(); i++) {
-        arguments.push_back(evaluate(expr->arguments[i]));
+Value Interpreter::visitCallExpr(Call<Value>* expr) {
+    Value callee = evaluate(expr->callee);
+    tempRoots.push_back(callee);
+    size_t base = tempRoots.size();
+    size_t argumentCount = expr->arguments.size();
+    for (Expr<Value>* argument : expr->arguments) {
+        tempRoots.push_back(evaluate(argument));
     }
-    IcarusCallable* function;
-    try {
-        IcarusFunction<std::any>* functionPtr = std::any_cast<IcarusFunction<std::any>*>(callee);
-        function = dynamic_cast<IcarusCallable*>(functionPtr);
-        /*
-        function = std::any_cast<IcarusFunction*>(callee);
-        */
-    } catch (const std::bad_any_cast& e) {
+    if (!callee.isCallable()) {
         throw new RuntimeError(expr->paren, "Can only call functions and classes");
     }
-    if (arguments.size() != function->arity()) {
-        throw new RuntimeError(expr->paren, "Expected " + std::to_string(function->arity()) + " arguments but got " + std::to_string(arguments.size()));
+    IcarusCallable* function = callee.asCallable();
+    if (argumentCount != (size_t) function->arity()) {
+        throw new RuntimeError(expr->paren, "Expected " + std::to_string(function->arity()) + " arguments but got " + std::to_string(argumentCount));
+    }
+    if (expr->tail && dynamic_cast<IcarusFunction<Value>*>(function) != nullptr) {
+        tailCall.assign(tempRoots.begin() + (base - 1), tempRoots.end());
+        tempRoots.resize(base - 1);
+        // the callee takes over the caller's place on the stack
+        callStack.back().name = function->name();
+        completion.type = TAIL_CALL_COMPLETION;
+        return nullptr;
+    }
+    int line = expr->paren->getLine();
+    if (Profiler::pending) {
+        sample(line);
+    }
+    if (callStack.size() > maxDepth) {
+        RuntimeError* error = new RuntimeError(expr->paren, "Stack overflow.");
+        error->trace = ErrorReporter::stackTrace(callStack, line);
+        throw error;
+    }
+    callStack.back().line = line;
+    callStack.push_back(ProfileFrame(function->name(), line));
+    Value result;
+    try {
+        result = function->call(this, tempRoots.data() + base);
+    } catch (NativeError& error) {
+        throw new RuntimeError(expr->paren, error.what());
     }
-    return function->call(this, arguments);
+    callStack.pop_back();
+    tempRoots.resize(base - 1);
+    return result;
 }
 
 
+//Fused variable comparisons
+Value Interpreter::visitCompareExpr(Compare<Value>* expr) {
+    Variable<Value>* left = expr->left;
+    Value a = lookUp(left->name, left->slot, left->cache);
+    Value b = expr->right == nullptr ? expr->constant : lookUp(expr->right->name, expr->right->slot, expr->right->cache);
+    if (Profiler::pending) {
+        sample(expr->operation->getLine());
+    }
+    checkNumberOperands(expr->operation, a, b);
+    switch (expr->operation->getType()) {
+        case GREATER: return a.asNumber() > b.asNumber();
+        case GREATER_EQUAL: return a.asNumber() >= b.asNumber();
+        case LESS: return a.asNumber() < b.asNumber();
+        default: return a.asNumber() <= b.asNumber();
+    }
+}
+
+//Fused increments
+Value Interpreter::visitIncrementExpr(Increment<Value>* expr) {
+    Value& variable = lookUp(expr->name, expr->slot, expr->cache);
+    if (Profiler::pending) {
+        sample(expr->operation->getLine());
+    }
+    if (!variable.isNumber()) {
+        if (expr->operation->getType() == PLUS) {
+            throw new RuntimeError(expr->operation, "Operands must be two numbers or two strings");
+        }
+        throw new RuntimeError(expr->operation, "Operands must be numbers");
+    }
+    variable = variable.asNumber() + expr->amount;
+    return variable;
+}
+
+// The specialization for the operand types a Binary node saw on its first
+// run. Anything but two numbers, or two strings being joined, stays generic.
+static QuickBinary quickening(TokenType operation, const Value& left, const Value& right) {
+    if (left.isNumber() && right.isNumber()) {
+        switch (operation) {
+            case PLUS: return QUICK_ADD_NUMBERS;
+            case MINUS: return QUICK_SUBTRACT_NUMBERS;
+            case STAR: return QUICK_MULTIPLY_NUMBERS;
+            case SLASH: return QUICK_DIVIDE_NUMBERS;
+            case GREATER: return QUICK_GREATER_NUMBERS;
+            case GREATER_EQUAL: return QUICK_GREATER_EQUAL_NUMBERS;
+            case LESS: return QUICK_LESS_NUMBERS;
+            case LESS_EQUAL: return QUICK_LESS_EQUAL_NUMBERS;
+            case EQUAL_EQUAL: return QUICK_EQUAL_NUMBERS;
+            case BANG_EQUAL: return QUICK_NOT_EQUAL_NUMBERS;
+            default: return QUICK_GENERIC;
+        }
+    }
+    if (left.isString() && right.isString() && operation == PLUS) {
+        return QUICK_CONCATENATE;
+    }
+    return QUICK_GENERIC;
+}
+
+#define QUICK_NUMBERS(op)                                  \
+    if (left.isNumber() && right.isNumber()) {             \
+        return left.asNumber() op right.asNumber();        \
+    }                                                      \
+    break
+
 //Binary Expressions
-std::any Interpreter::visitBinaryExpr(Binary<std::any>* expr){
-    std::any left = evaluate(expr->left);
-    std::any right = evaluate(expr->right);
+Value Interpreter::visitBinaryExpr(Binary<Value>* expr){
+    Value left = evaluate(expr->left);
+    tempRoots.push_back(left);
+    Value right = evaluate(expr->right);
+    tempRoots.pop_back();
+    if (Profiler::pending) {
+        sample(expr->operation->getLine());
+    }
 
+    // a quickened node only checks that its operands still have the types
+    // it was specialized for
+    switch (expr->quick) {
+        case QUICK_ADD_NUMBERS: QUICK_NUMBERS(+);
+        case QUICK_SUBTRACT_NUMBERS: QUICK_NUMBERS(-);
+        case QUICK_MULTIPLY_NUMBERS: QUICK_NUMBERS(*);
+        case QUICK_DIVIDE_NUMBERS: QUICK_NUMBERS(/);
+        case QUICK_GREATER_NUMBERS: QUICK_NUMBERS(>);
+        case QUICK_GREATER_EQUAL_NUMBERS: QUICK_NUMBERS(>=);
+        case QUICK_LESS_NUMBERS: QUICK_NUMBERS(<);
+        case QUICK_LESS_EQUAL_NUMBERS: QUICK_NUMBERS(<=);
+        case QUICK_EQUAL_NUMBERS: QUICK_NUMBERS(==);
+        case QUICK_NOT_EQUAL_NUMBERS: QUICK_NUMBERS(!=);
+        case QUICK_CONCATENATE:
+            if (left.isString() && right.isString()) {
+                return gc->concatenate(left.asStringObject(), right.asStringObject());
+            }
+            break;
+        case QUICK_NONE:
+            expr->quick = quickening(expr->operation->getType(), left, right);
+            if (expr->quick != QUICK_GENERIC) {
+                cacheStats.quickened++;
+            }
+            return binaryOperation(expr, left, right);
+        case QUICK_GENERIC:
+            return binaryOperation(expr, left, right);
+    }
+    expr->quick = QUICK_GENERIC;
+    cacheStats.deoptimized++;
+    return binaryOperation(expr, left, right);
+}
+
+#undef QUICK_NUMBERS
+
+Value Interpreter::binaryOperation(Binary<Value>* expr, const Value& left, const Value& right) {
     switch(expr->operation->getType()) {
         case GREATER:
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) > std::any_cast<double>(right);
+            return left.asNumber() > right.asNumber();
         }
             break;
 
         case GREATER_EQUAL: 
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) >= std::any_cast<double>(right);
+            return left.asNumber() >= right.asNumber();
         }
             break;
         case LESS:
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) < std::any_cast<double>(right);
+            return left.asNumber() < right.asNumber();
         }
             break;
 
         case LESS_EQUAL:
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) <= std::any_cast<double>(right);
+            return left.asNumber() <= right.asNumber();
         }
             break;
         case MINUS:
 
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) - std::any_cast<double>(right);
+            return left.asNumber() - right.asNumber();
         }
             break;
 
         case PLUS:
         { 
-            if ((left.type() == typeid(double)) && right.type() == typeid(double)) {
-                double leftNum = std::any_cast<double>(left);
-                double rightNum = std::any_cast<double>(right);
+            if (left.isNumber() && right.isNumber()) {
+                double leftNum = left.asNumber();
+                double rightNum = right.asNumber();
                 return leftNum + rightNum;
             }
-            else if (left.type() == typeid(std::string) && right.type() == typeid(std::string)) {
-                return std::any_cast<std::string>(left)+(std::any_cast<std::string>(right));
+            else if (left.isString() && right.isString()) {
+                return gc->concatenate(left.asStringObject(), right.asStringObject());
             }
 
             throw new RuntimeError(expr->operation, "Operands must be two numbers or two strings");
@@ -227,7 +378,7 @@ std::any Interpreter::visitBinaryExpr(Binary<std::any>* expr){
         case SLASH:
         {
             checkNumberOperands(expr->operation, left, right);
-            return std::any_cast<double>(left) / std::any_cast<double>(right);
+            return left.asNumber() / right.asNumber();
         }
             break;
 
@@ -235,15 +386,15 @@ std::any Interpreter::visitBinaryExpr(Binary<std::any>* expr){
         {
             checkNumberOperands(expr->operation, left, right);
 
-            return std::any_cast<double>(left) * std::any_cast<double>(right);
+            return left.asNumber() * right.asNumber();
         }
             break;
 
         case BANG_EQUAL:
-            return !isEqual(left, right);
+            return !left.equals(right);
 
         case EQUAL_EQUAL:
-            return isEqual(left, right);
+            return left.equals(right);
         default:
             return nullptr;
     }
@@ -252,26 +403,63 @@ std::any Interpreter::visitBinaryExpr(Binary<std::any>* expr){
 
 
 //Grouping expressions
-std::any Interpreter::visitGroupingExpr(Grouping<std::any>* expr){
+Value Interpreter::visitGroupingExpr(Grouping<Value>* expr){
     return evaluate(expr->expression);
 }
 
 
+//Index expressions
+Value Interpreter::visitIndexExpr(Index<Value>* expr) {
+    Value object = evaluate(expr->object);
+    tempRoots.push_back(object);
+    Value index = evaluate(expr->index);
+    tempRoots.pop_back();
+    if (object.isMap()) {
+        if (const char* problem = IcarusMap::checkKey(index)) {
+            throw new RuntimeError(expr->bracket, problem);
+        }
+        // a missing key reads as nil
+        Value value;
+        object.asMap()->get(index, value);
+        return value;
+    }
+    if (!object.isList()) {
+        throw new RuntimeError(expr->bracket, "Only lists and maps can be indexed");
+    }
+    size_t position;
+    if (const char* problem = object.asList()->checkIndex(index, position)) {
+        throw new RuntimeError(expr->bracket, problem);
+    }
+    return object.asList()->elements[position];
+}
+
+//List literals
+Value Interpreter::visitListExpr(List<Value>* expr) {
+    // elements stay rooted on tempRoots until the list holds them
+    size_t base = tempRoots.size();
+    for (Expr<Value>* element : expr->elements) {
+        tempRoots.push_back(evaluate(element));
+    }
+    IcarusList* list = gc->allocate<IcarusList>(std::vector<Value>(tempRoots.begin() + base, tempRoots.end()));
+    tempRoots.resize(base);
+    return list;
+}
+
 //Literal expressions
-std::any Interpreter::visitLiteralExpr(Literal<std::any>* expr){
+Value Interpreter::visitLiteralExpr(Literal<Value>* expr){
     return expr->value;
 }
 
 //Logical Expressions
-std::any Interpreter::visitLogicalExpr(Logical<std::any>* expr) {
-    std::any left = evaluate(expr->left);
+Value Interpreter::visitLogicalExpr(Logical<Value>* expr) {
+    Value left = evaluate(expr->left);
     if (expr->operation->getType() == OR) {
-        if (isTruthy(left)) { //short circuit and return true given that left was true
+        if (left.isTruthy()) { //short circuit and return true given that left was true
             return left;
         }
     }
     else {
-        if (!isTruthy(left)) { //short circuit given 'AND' operation and left was false
+        if (!left.isTruthy()) { //short circuit given 'AND' operation and left was false
             return left;
         }
     }
@@ -279,16 +467,66 @@ std::any Interpreter::visitLogicalExpr(Logical<std::any>* expr) {
 }
 
 
+//Index assignments
+Value Interpreter::visitSetIndexExpr(SetIndex<Value>* expr) {
+    Value object = evaluate(expr->object);
+    tempRoots.push_back(object);
+    Value index = evaluate(expr->index);
+    tempRoots.push_back(index);
+    Value value = evaluate(expr->value);
+    if (object.isMap()) {
+        if (const char* problem = IcarusMap::checkKey(index)) {
+            throw new RuntimeError(expr->bracket, problem);
+        }
+        object.asMap()->set(index, value);
+        // the map is still rooted, and holds value, should growing collect
+        gc->grew(object.asMap());
+        tempRoots.resize(tempRoots.size() - 2);
+        return value;
+    }
+    tempRoots.resize(tempRoots.size() - 2);
+    if (!object.isList()) {
+        throw new RuntimeError(expr->bracket, "Only lists and maps can be indexed");
+    }
+    size_t position;
+    if (const char* problem = object.asList()->checkIndex(index, position)) {
+        throw new RuntimeError(expr->bracket, problem);
+    }
+    object.asList()->elements[position] = value;
+    return value;
+}
+
+//Map literals
+Value Interpreter::visitMapExpr(Map<Value>* expr) {
+    // entries stay rooted on tempRoots until the map holds them
+    size_t base = tempRoots.size();
+    for (size_t i = 0; i < expr->keys.size(); i++) {
+        tempRoots.push_back(evaluate(expr->keys[i]));
+        tempRoots.push_back(evaluate(expr->values[i]));
+    }
+    IcarusMap* map = gc->allocate<IcarusMap>();
+    for (size_t i = base; i < tempRoots.size(); i += 2) {
+        if (const char* problem = IcarusMap::checkKey(tempRoots[i])) {
+            throw new RuntimeError(expr->brace, problem);
+        }
+        map->set(tempRoots[i], tempRoots[i + 1]);
+    }
+    tempRoots.resize(base);
+    tempRoots.push_back(map);
+    gc->grew(map);
+    tempRoots.pop_back();
+    return map;
+}
+
 //Unary expressions
-std::any Interpreter::visitUnaryExpr(Unary<std::any>* expr){
-    std::any right = evaluate(expr->right);
+Value Interpreter::visitUnaryExpr(Unary<Value>* expr){
+    Value right = evaluate(expr->right);
     switch(expr->operation->getType()) {
         case BANG:
-            return isTruthy(right);
+            return !right.isTruthy();
         case MINUS:
             checkNumberOperand(expr->operation, right);
-            if (right.type() == typeid(double))
-                return -(std::any_cast<double>(right));
+            return -(right.asNumber());
             break;
         default:
             return nullptr;
@@ -297,84 +535,104 @@ std::any Interpreter::visitUnaryExpr(Unary<std::any>* expr){
 }
 
 //variable expressions
-std::any Interpreter::visitVariableExpr(Variable<std::any>* expr) {
-    return lookUpVariable(expr->name, expr);
+Value Interpreter::visitVariableExpr(Variable<Value>* expr) {
+    return lookUp(expr->name, expr->slot, expr->cache);
 }
 
 //STATEMENTS
 
-std::any Interpreter::visitBlockStmt(Block<std::any>* stmt) {
-    executeBlock(stmt->statements, new Environment(this->env));
+Value Interpreter::visitBlockStmt(Block<Value>* stmt) {
+    executeBlock(stmt->statements, gc->allocate<Environment>(this->env));
     return nullptr;
 }
 
 
 //expression statements
-std::any Interpreter::visitExpressionStmt(Expression<std::any>* stmt) {
+Value Interpreter::visitExpressionStmt(Expression<Value>* stmt) {
     evaluate(stmt->expression);
     return nullptr;
 }
 
 //function statements
-std::any Interpreter::visitFunctionStmt(Function<std::any>* stmt) {
-    IcarusFunction<std::any>* function = new IcarusFunction<std::any>(stmt, this->env);
-    this->env->define(stmt->name->getLexeme(), function);
+Value Interpreter::visitFunctionStmt(Function<Value>* stmt) {
+    IcarusFunction<Value>* function = gc->allocate<IcarusFunction<Value>>(stmt, this->env);
+    define(stmt->name, function);
     return nullptr;
 }
 
 //if statements
-std::any Interpreter::visitIfStmt(If<std::any>* stmt) {
-    if (isTruthy(evaluate(stmt->condition))) {
+Value Interpreter::visitIfStmt(If<Value>* stmt) {
+    if (evaluate(stmt->condition).isTruthy()) {
         execute(stmt->thenBranch);
     }
-    else {
+    else if (stmt->elseBranch != nullptr) {
         execute(stmt->elseBranch);
     }
     return nullptr;
 }
 
 //Print statements
-std::any Interpreter::visitPrintStmt(Print<std::any>* stmt) {
-    std::any value = evaluate(stmt->expression);
-    std::cout << stringify(value) << std::endl;
+Value Interpreter::visitPrintStmt(Print<Value>* stmt) {
+    Value value = evaluate(stmt->expression);
+    *out << value.toString() << std::endl;
     return nullptr;
 }
 
 //Return statements
-std::any Interpreter::visitReturnStmt(Return<std::any>* stmt) {
-    std::any value = nullptr;
+Value Interpreter::visitReturnStmt(Return<Value>* stmt) {
+    Value value = nullptr;
     if (stmt->value != nullptr) {
         value = evaluate(stmt->value);
+        if (completion.type == TAIL_CALL_COMPLETION) {
+            return nullptr;
+        }
     }
-    throw new StackUnwinder(value);
+    completion.type = RETURN_COMPLETION;
+    completion.value = value;
+    return nullptr;
 }
 
 //Var statements
-std::any Interpreter::visitVarStmt(Var<std::any>* stmt) {
-    std::any value = nullptr;
+Value Interpreter::visitVarStmt(Var<Value>* stmt) {
+    Value value = nullptr;
     if (stmt->initializer != nullptr) {
         value = evaluate(stmt->initializer);
     }
-    env->define(stmt->name->getLexeme(), value);
+    define(stmt->name, value);
+    return nullptr;
+}
+
+Value Interpreter::visitVarLiteralStmt(VarLiteral<Value>* stmt) {
+    define(stmt->name, stmt->value);
     return nullptr;
 }
 
 //While statements
-std::any Interpreter::visitWhileStmt(While<std::any>* stmt) {
-    while (isTruthy(evaluate(stmt->condition))) {
-        execute(stmt->body);
+Value Interpreter::visitWhileStmt(While<Value>* stmt) {
+    while (evaluate(stmt->condition).isTruthy()) {
+        if (execute(stmt->body) != NORMAL_COMPLETION) {
+            break;
+        }
     }
     return nullptr;
 }
 
 //interpret statements
-std::any Interpreter::interpret(std::vector<Stmt<std::any>*> statements) {
+Value Interpreter::interpret(std::vector<Stmt<Value>*> statements) {
+    callStack.clear();
+    callStack.push_back(ProfileFrame("script", 0));
     try {
-        for (Stmt<std::any>* stmt : statements) {
-            execute(stmt);
+        for (Stmt<Value>* stmt : statements) {
+            if (execute(stmt) != NORMAL_COMPLETION) {
+                break;
+            }
         }
     } catch (RuntimeError* error){
-        Icarus::runtimeError(error);
+        errors->runtimeError(error);
+        this->env = globals;
+        envStack.clear();
+        tempRoots.clear();
     }
+    completion = Completion();
     return nullptr;
 }
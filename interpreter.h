@@ -1,7 +1,7 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
-#include <any>
+#include "value.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -9,53 +9,127 @@
 #include "expr.h"
 #include "stmt.h"
 #include "env.h"
+#include "gc.h"
+#include "inline_cache.h"
+#include "profiler.h"
+#include "node_stats.h"
+#include "slot.h"
+#include "error_reporter.h"
 
+enum CompletionType { NORMAL_COMPLETION, RETURN_COMPLETION, TAIL_CALL_COMPLETION };
 
-class Interpreter : public Expr<std::any>::Visitor<std::any>, public Stmt<std::any>::Visitor<std::any> {
+// How the most recently executed statement finished. A return statement
+// records its value here and every enclosing block, loop and function call
+// checks the type after each statement, so returning never has to unwind
+// the C++ stack with an exception. A return whose value is a call to a Lox
+// function finishes with TAIL_CALL_COMPLETION instead, leaving the call for
+// the function being returned from to make once its frame is gone.
+class Completion {
+    public:
+        CompletionType type;
+        Value value;
+        Completion() {
+            this->type = NORMAL_COMPLETION;
+        }
+};
+
+class Interpreter : public Expr<Value>::Visitor<Value>, public Stmt<Value>::Visitor<Value>, public GcRoots {
     private:
+        // Environments of the blocks and calls we are nested in, and values
+        // held in C++ locals while a subexpression is evaluated. Neither is
+        // reachable from env, so both are handed to the collector as roots.
+        // Call arguments are evaluated straight onto tempRoots, which doubles
+        // as the argument stack callees read them from.
+        std::vector<Environment*> envStack;
+        std::vector<Value> tempRoots;
+        // callee and arguments of the pending tail call
+        std::vector<Value> tailCall;
+
+        Value evaluate(Expr<Value>* expr);
+        CompletionType execute(Stmt<Value>* stmt);
 
-        std::any evaluate(Expr<std::any>* expr);
-        std::any execute(Stmt<std::any>* stmt);
+        void define(Token* name, const Value& value);
+        // where a resolved variable is stored, filling the node's cache for
+        // a global
+        Value& lookUp(Token* name, Slot& slot, GlobalCache& cache);
 
-        std::any lookUpVariable(Token* name, Expr<std::any>* expr);
+        // Lox functions currently running, outermost (the script) first,
+        // each with the line it was at when it made the call above it. A
+        // tail call replaces the caller's frame rather than adding one.
+        std::vector<ProfileFrame> callStack;
+        void sample(int line);
 
-        bool isEqual(std::any A, std::any B);
-        bool isTruthy(std::any object);
-        void checkNumberOperand(Token* operation, std::any operand); 
-        void checkNumberOperands(Token* operation, std::any left, std::any right);
-        std::string stringify(std::any object);
+        // every operator on operands of any type, checking them first
+        Value binaryOperation(Binary<Value>* expr, const Value& left, const Value& right);
+
+        void checkNumberOperand(Token* operation, const Value& operand); 
+        void checkNumberOperands(Token* operation, const Value& left, const Value& right);
 
     public:
-        unordered_map<Expr<std::any>*, int> locals;
         Environment* env;
         Environment* globals;
+        Completion completion;
+        GarbageCollector* gc;
+        InlineCacheStats cacheStats;
+        Profiler* profiler;
+        ErrorReporter* errors;
+        std::ostream* out;
+        // calls that may be in progress at once before a call fails with a
+        // stack overflow; tail calls do not count
+        size_t maxDepth;
+#ifdef ICARUS_NODE_STATS
+        NodeStats nodeStats;
+#endif
+
+        static const size_t DEFAULT_MAX_DEPTH = 10000;
+
+        Interpreter(GarbageCollector* gc, ErrorReporter* errors);
 
-        Interpreter();
+        void markRoots(GarbageCollector* gc);
         
-        void resolve(Expr<std::any>* stmt, int depth);
-
-        std::any executeBlock(std::vector<Stmt<std::any>*> statements, Environment* environment);
-
-        std::any visitAssignExpr(Assign<std::any>* expr);
-        std::any visitCallExpr(Call<std::any>* expr);
-        std::any visitBinaryExpr(Binary<std::any>* expr);
-        std::any visitGroupingExpr(Grouping<std::any>* expr);
-        std::any visitLiteralExpr(Literal<std::any>* expr);
-        std::any visitLogicalExpr(Logical<std::any>* expr);
-        std::any visitUnaryExpr(Unary<std::any>* expr);
-        std::any visitVariableExpr(Variable<std::any>* expr);
-
-        std::any visitBlockStmt(Block<std::any>* stmt);
-        std::any visitExpressionStmt(Expression<std::any>* stmt);
-        std::any visitFunctionStmt(Function<std::any>* stmt); 
-        std::any visitIfStmt(If<std::any>* stmt);
-        std::any visitPrintStmt(Print<std::any>* stmt);
-        std::any visitReturnStmt(Return<std::any>* stmt);
-        std::any visitVarStmt(Var<std::any>* stmt);
-        std::any visitWhileStmt(While<std::any>* stmt);
-
-        std::any interpret(std::vector<Stmt<std::any> *> statements);
-        ~Interpreter() = default;
+        // slot of the global called name, for the resolver
+        int globalSlot(std::string name);
+
+        // starts over with no globals defined
+        void resetGlobals();
+
+        CompletionType executeBlock(const std::vector<Stmt<Value>*>& statements, Environment* environment);
+
+        // value of the return that ended the current call, resetting the
+        // completion so execution carries on normally in the caller
+        Value takeReturnValue();
+
+        // callee of the tail call that ended the current call, followed by
+        // its arguments; they stay rooted until the next tail call
+        const Value* takeTailCall();
+
+        Value visitAssignExpr(Assign<Value>* expr);
+        Value visitCallExpr(Call<Value>* expr);
+        Value visitBinaryExpr(Binary<Value>* expr);
+        Value visitCompareExpr(Compare<Value>* expr);
+        Value visitGroupingExpr(Grouping<Value>* expr);
+        Value visitIncrementExpr(Increment<Value>* expr);
+        Value visitIndexExpr(Index<Value>* expr);
+        Value visitListExpr(List<Value>* expr);
+        Value visitLiteralExpr(Literal<Value>* expr);
+        Value visitLogicalExpr(Logical<Value>* expr);
+        Value visitMapExpr(Map<Value>* expr);
+        Value visitSetIndexExpr(SetIndex<Value>* expr);
+        Value visitUnaryExpr(Unary<Value>* expr);
+        Value visitVariableExpr(Variable<Value>* expr);
+
+        Value visitBlockStmt(Block<Value>* stmt);
+        Value visitExpressionStmt(Expression<Value>* stmt);
+        Value visitFunctionStmt(Function<Value>* stmt); 
+        Value visitIfStmt(If<Value>* stmt);
+        Value visitPrintStmt(Print<Value>* stmt);
+        Value visitReturnStmt(Return<Value>* stmt);
+        Value visitVarStmt(Var<Value>* stmt);
+        Value visitVarLiteralStmt(VarLiteral<Value>* stmt);
+        Value visitWhileStmt(While<Value>* stmt);
+
+        Value interpret(std::vector<Stmt<Value> *> statements);
+        ~Interpreter();
 
 };
 
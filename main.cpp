@@ -23,12 +23,70 @@ void handler(int sig) {
 
 int main(int argc, char** argv){
     signal(SIGSEGV, handler);
-    if (argc > 2) {
-        std::cout << "Usage: icarus [script]" << std::endl;
-        exit(1);
+    char* script = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vm") {
+            Icarus::session->useVM = true;
+        }
+        else if (arg == "--gc-stats") {
+            Icarus::gcStats = true;
+        }
+        else if (arg == "--cache-stats") {
+            Icarus::cacheStats = true;
+        }
+        else if (arg == "--alloc-stats") {
+            Icarus::allocStats = true;
+        }
+        else if (arg == "--no-optimize") {
+            Icarus::session->optimize = false;
+        }
+        else if (arg == "--dump-ast") {
+            Icarus::session->dumpAst = true;
+        }
+        else if (arg.rfind("--max-depth=", 0) == 0) {
+            long depth = atol(arg.c_str() + 12);
+            if (depth <= 0) {
+                std::cout << "--max-depth needs a positive number of calls" << std::endl;
+                exit(1);
+            }
+            Icarus::session->maxDepth = depth;
+        }
+        else if (arg == "--profile" || arg.rfind("--profile=", 0) == 0) {
+            std::string path = arg == "--profile" ? "icarus.folded" : arg.substr(10);
+            // sample once per millisecond of cpu time
+            Icarus::session->profiler = new Profiler(path, 1000);
+        }
+        else if (script == nullptr && arg.rfind("--", 0) != 0) {
+            script = argv[i];
+        }
+        else {
+            std::cout << "Usage: icarus [--vm] [--gc-stats] [--cache-stats] [--alloc-stats] [--profile[=file]] [--no-optimize] [--dump-ast] [--max-depth=calls] [script | -]" << std::endl;
+            exit(1);
+        }
     }
-    else if (argc == 2) {
-        Icarus::runFile(argv[1]);
+    if (Icarus::gcStats) {
+        Icarus::session->gc->setStatsHook([](const GcStats& stats) {
+            std::cerr << "[gc] collection " << stats.collections << ": heap " << stats.heapBytes
+                      << " bytes, pause " << stats.lastPauseMs << "ms" << std::endl;
+        });
+        atexit(Icarus::reportGcStats);
+    }
+    if (Icarus::cacheStats) {
+        atexit(Icarus::reportCacheStats);
+    }
+    if (Icarus::allocStats) {
+        atexit(Icarus::reportAllocStats);
+    }
+#ifdef ICARUS_NODE_STATS
+    atexit(Icarus::reportNodeStats);
+#endif
+    if (Icarus::session->profiler != nullptr) {
+        Icarus::session->profiler->start();
+        atexit(Icarus::writeProfile);
+    }
+    if (script != nullptr) {
+        Icarus::runFile(script);
     }
     else {
         Icarus::runPrompt();
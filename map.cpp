@@ -0,0 +1,148 @@
+#include <cstring>
+
+#include "value.h"
+#include "gc.h"
+
+static const size_t MIN_CAPACITY = 8;
+
+static uint32_t hashKey(const Value& key) {
+    if (key.isString()) {
+        return key.asStringObject()->hashCode();
+    }
+    // 0 and -0 are equal, so they have to hash alike
+    double number = key.asNumber() == 0 ? 0 : key.asNumber();
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdull;
+    bits ^= bits >> 33;
+    return (uint32_t) bits;
+}
+
+static bool sameKey(const Value& a, const Value& b) {
+    if (a.getType() != b.getType()) {
+        return false;
+    }
+    if (a.isNumber()) {
+        return a.asNumber() == b.asNumber();
+    }
+    IcarusString* left = a.asStringObject();
+    IcarusString* right = b.asStringObject();
+    return left == right || (left->hashCode() == right->hashCode() && left->equals(right));
+}
+
+IcarusMap::IcarusMap() {
+    this->count = 0;
+    this->used = 0;
+}
+
+const char* IcarusMap::checkKey(const Value& key) {
+    if (key.isString()) {
+        return nullptr;
+    }
+    if (key.isNumber() && key.asNumber() == key.asNumber()) {
+        return nullptr;
+    }
+    return "Map keys must be strings or numbers";
+}
+
+// The entry holding key, or the entry it should be inserted into: the first
+// tombstone passed on the way, else the empty entry that ended the probe.
+IcarusMap::Entry* IcarusMap::find(const Value& key) {
+    size_t mask = entries.size() - 1;
+    size_t index = hashKey(key) & mask;
+    Entry* tombstone = nullptr;
+    while (true) {
+        Entry* entry = &entries[index];
+        if (entry->key.isNil()) {
+            if (entry->value.isNil()) {
+                return tombstone != nullptr ? tombstone : entry;
+            }
+            if (tombstone == nullptr) {
+                tombstone = entry;
+            }
+        }
+        else if (sameKey(entry->key, key)) {
+            return entry;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+// Doubles the table once it is three quarters full, counting tombstones, and
+// reinserts the live entries, which drops the tombstones.
+void IcarusMap::grow() {
+    size_t capacity = entries.empty() ? MIN_CAPACITY : entries.size();
+    if (count * 2 >= capacity) {
+        capacity *= 2;
+    }
+    std::vector<Entry> old(capacity);
+    old.swap(entries);
+    count = 0;
+    used = 0;
+    for (Entry& entry : old) {
+        if (!entry.key.isNil()) {
+            Entry* slot = find(entry.key);
+            *slot = entry;
+            count++;
+            used++;
+        }
+    }
+}
+
+bool IcarusMap::get(const Value& key, Value& value) {
+    if (count == 0) {
+        return false;
+    }
+    Entry* entry = find(key);
+    if (entry->key.isNil()) {
+        return false;
+    }
+    value = entry->value;
+    return true;
+}
+
+void IcarusMap::set(const Value& key, const Value& value) {
+    if ((used + 1) * 4 > entries.size() * 3) {
+        grow();
+    }
+    Entry* entry = find(key);
+    if (entry->key.isNil()) {
+        count++;
+        // reusing a tombstone does not make the table any fuller
+        if (entry->value.isNil()) {
+            used++;
+        }
+        entry->key = key;
+    }
+    entry->value = value;
+}
+
+bool IcarusMap::remove(const Value& key) {
+    if (count == 0) {
+        return false;
+    }
+    Entry* entry = find(key);
+    if (entry->key.isNil()) {
+        return false;
+    }
+    entry->key = Value();
+    entry->value = true;
+    count--;
+    return true;
+}
+
+void IcarusMap::keys(std::vector<Value>& out) {
+    for (Entry& entry : entries) {
+        if (!entry.key.isNil()) {
+            out.push_back(entry.key);
+        }
+    }
+}
+
+void IcarusMap::trace(GarbageCollector* gc) {
+    for (Entry& entry : entries) {
+        gc->markValue(entry.key);
+        gc->markValue(entry.value);
+    }
+}
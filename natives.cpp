@@ -0,0 +1,148 @@
+#include <chrono>
+#include <cmath>
+#include <charconv>
+
+#include "natives.h"
+
+static double numberArgument(const Value& value, const char* function) {
+    if (!value.isNumber()) {
+        throw NativeError(std::string(function) + " expects a number");
+    }
+    return value.asNumber();
+}
+
+static const std::string& stringArgument(const Value& value, const char* function) {
+    if (!value.isString()) {
+        throw NativeError(std::string(function) + " expects a string");
+    }
+    return value.asString();
+}
+
+// seconds since an arbitrary point, for timing scripts
+static Value nativeClock(GarbageCollector* gc, const Value* arguments) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now().time_since_epoch();
+    return elapsed.count();
+}
+
+static Value nativeSqrt(GarbageCollector* gc, const Value* arguments) {
+    return std::sqrt(numberArgument(arguments[0], "sqrt"));
+}
+
+static Value nativeFloor(GarbageCollector* gc, const Value* arguments) {
+    return std::floor(numberArgument(arguments[0], "floor"));
+}
+
+static IcarusList* listArgument(const Value& value, const char* function) {
+    if (!value.isList()) {
+        throw NativeError(std::string(function) + " expects a list");
+    }
+    return value.asList();
+}
+
+static IcarusMap* mapArgument(const Value& value, const Value& key, const char* function) {
+    if (!value.isMap()) {
+        throw NativeError(std::string(function) + " expects a map");
+    }
+    if (const char* problem = IcarusMap::checkKey(key)) {
+        throw NativeError(problem);
+    }
+    return value.asMap();
+}
+
+// length of a string, list or map
+static Value nativeLen(GarbageCollector* gc, const Value* arguments) {
+    if (arguments[0].isList()) {
+        return (double) arguments[0].asList()->elements.size();
+    }
+    if (arguments[0].isMap()) {
+        return (double) arguments[0].asMap()->length();
+    }
+    if (arguments[0].isString()) {
+        // a rope knows its length without being flattened
+        return (double) arguments[0].asStringObject()->length();
+    }
+    return (double) stringArgument(arguments[0], "len").size();
+}
+
+// appends to a list in amortized constant time
+static Value nativePush(GarbageCollector* gc, const Value* arguments) {
+    IcarusList* list = listArgument(arguments[0], "push");
+    list->elements.push_back(arguments[1]);
+    gc->grew(list);
+    return nullptr;
+}
+
+// removes and returns the last element of a list
+static Value nativePop(GarbageCollector* gc, const Value* arguments) {
+    IcarusList* list = listArgument(arguments[0], "pop");
+    if (list->elements.empty()) {
+        throw NativeError("pop from an empty list");
+    }
+    Value last = list->elements.back();
+    list->elements.pop_back();
+    return last;
+}
+
+// substr(text, start, length), with start and length whole numbers inside text
+static Value nativeSubstr(GarbageCollector* gc, const Value* arguments) {
+    const std::string& text = stringArgument(arguments[0], "substr");
+    double start = numberArgument(arguments[1], "substr");
+    double length = numberArgument(arguments[2], "substr");
+    if (start != std::floor(start) || length != std::floor(length)
+            || start < 0 || length < 0 || start + length > text.size()) {
+        throw NativeError("substr range out of bounds");
+    }
+    return gc->newString(text.substr((size_t) start, (size_t) length));
+}
+
+static Value nativeHas(GarbageCollector* gc, const Value* arguments) {
+    Value value;
+    return mapArgument(arguments[0], arguments[1], "has")->get(arguments[1], value);
+}
+
+// removes a key from a map, returning whether it was there
+static Value nativeDelete(GarbageCollector* gc, const Value* arguments) {
+    return mapArgument(arguments[0], arguments[1], "delete")->remove(arguments[1]);
+}
+
+// a new list of the keys of a map
+static Value nativeKeys(GarbageCollector* gc, const Value* arguments) {
+    if (!arguments[0].isMap()) {
+        throw NativeError("keys expects a map");
+    }
+    // the map keeps the keys alive until the list holds them
+    std::vector<Value> keys;
+    arguments[0].asMap()->keys(keys);
+    return gc->allocate<IcarusList>(std::move(keys));
+}
+
+// the number text spells, or nil if it is not one
+static Value nativeNumber(GarbageCollector* gc, const Value* arguments) {
+    const std::string& text = stringArgument(arguments[0], "number");
+    double number;
+    const char* end = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), end, number);
+    if (result.ec != std::errc() || result.ptr != end) {
+        return nullptr;
+    }
+    return number;
+}
+
+// a function rather than a global so that sessions created during static
+// initialization can already use it
+const std::vector<NativeSpec>& standardNatives() {
+    static const std::vector<NativeSpec> natives = {
+        {"clock", 0, nativeClock},
+        {"sqrt", 1, nativeSqrt},
+        {"floor", 1, nativeFloor},
+        {"len", 1, nativeLen},
+        {"substr", 3, nativeSubstr},
+        {"number", 1, nativeNumber},
+        {"push", 2, nativePush},
+        {"pop", 1, nativePop},
+        {"has", 2, nativeHas},
+        {"delete", 2, nativeDelete},
+        {"keys", 1, nativeKeys},
+    };
+    return natives;
+}
@@ -0,0 +1,77 @@
+#ifndef NATIVES_H
+#define NATIVES_H
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "value.h"
+#include "gc.h"
+#include "icarus_callable.h"
+
+// Thrown by a native function when its arguments are wrong. Natives do not
+// know where they were called from, so the engine that made the call turns
+// this into a RuntimeError carrying the call's line.
+class NativeError : public std::runtime_error {
+    public:
+        NativeError(const std::string& message) : std::runtime_error(message) {}
+};
+
+// A builtin receives exactly as many arguments as it declared; the caller
+// has already checked the count, but not the types. Strings it returns must
+// come from gc.
+typedef Value (*NativeFn)(GarbageCollector* gc, const Value* arguments);
+
+// Host function callable from Lox on either engine. Calling one copies no
+// arguments into an Environment: both engines hand it a pointer to the
+// values they already hold.
+class NativeFunction : public IcarusCallable {
+    private:
+        // its own copy, since the native outlives every source's names
+        std::string functionName;
+        int argumentCount;
+        NativeFn function;
+        GarbageCollector* gc;
+
+    public:
+        NativeFunction(std::string_view name, int arity, NativeFn function, GarbageCollector* gc) {
+            this->functionName = name;
+            this->argumentCount = arity;
+            this->function = function;
+            this->gc = gc;
+        }
+
+        int arity() {
+            return argumentCount;
+        }
+
+        std::string_view name() {
+            return functionName;
+        }
+
+        Value invoke(const Value* arguments) {
+            return function(gc, arguments);
+        }
+
+        Value call(Interpreter* interpreter, const Value* arguments) {
+            return function(gc, arguments);
+        }
+
+        size_t size() {
+            return sizeof(NativeFunction);
+        }
+};
+
+class NativeSpec {
+    public:
+        const char* name;
+        int arity;
+        NativeFn function;
+};
+
+// clock, sqrt, floor, len, substr, number, push, pop, has, delete and keys,
+// defined in every session
+const std::vector<NativeSpec>& standardNatives();
+
+#endif
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <iomanip>
+
+#include "node_stats.h"
+
+// Fills in the label and source line of a node the first time it is seen.
+// Literals carry no token, so they and blocks without statements report
+// line 0.
+class NodeDescriber : public Expr<Value>::Visitor<Value>, public Stmt<Value>::Visitor<Value> {
+    private:
+        NodeStat& stat;
+
+        int lineOf(Expr<Value>* expr) {
+            NodeStat inner;
+            NodeDescriber describer(inner);
+            expr->accept(&describer);
+            return inner.line;
+        }
+
+        int lineOf(Stmt<Value>* stmt) {
+            NodeStat inner;
+            NodeDescriber describer(inner);
+            stmt->accept(&describer);
+            return inner.line;
+        }
+
+        Value describe(std::string label, int line) {
+            stat.label = label;
+            stat.line = line;
+            return nullptr;
+        }
+
+    public:
+        NodeDescriber(NodeStat& stat) : stat(stat) {}
+
+        Value visitAssignExpr(Assign<Value>* expr) {
+            return describe("assign " + std::string(expr->name->getLexeme()), expr->name->getLine());
+        }
+
+        Value visitBinaryExpr(Binary<Value>* expr) {
+            return describe("binary " + std::string(expr->operation->getLexeme()), expr->operation->getLine());
+        }
+
+        Value visitCallExpr(Call<Value>* expr) {
+            return describe("call", expr->paren->getLine());
+        }
+
+        Value visitCompareExpr(Compare<Value>* expr) {
+            return describe("compare " + std::string(expr->operation->getLexeme()), expr->operation->getLine());
+        }
+
+        Value visitGroupingExpr(Grouping<Value>* expr) {
+            return describe("grouping", lineOf(expr->expression));
+        }
+
+        Value visitIncrementExpr(Increment<Value>* expr) {
+            return describe("increment " + std::string(expr->name->getLexeme()), expr->name->getLine());
+        }
+
+        Value visitIndexExpr(Index<Value>* expr) {
+            return describe("index", expr->bracket->getLine());
+        }
+
+        Value visitListExpr(List<Value>* expr) {
+            return describe("list", expr->bracket->getLine());
+        }
+
+        Value visitLiteralExpr(Literal<Value>* expr) {
+            return describe("literal", 0);
+        }
+
+        Value visitLogicalExpr(Logical<Value>* expr) {
+            return describe("logical " + std::string(expr->operation->getLexeme()), expr->operation->getLine());
+        }
+
+        Value visitMapExpr(Map<Value>* expr) {
+            return describe("map", expr->brace->getLine());
+        }
+
+        Value visitSetIndexExpr(SetIndex<Value>* expr) {
+            return describe("set index", expr->bracket->getLine());
+        }
+
+        Value visitUnaryExpr(Unary<Value>* expr) {
+            return describe("unary " + std::string(expr->operation->getLexeme()), expr->operation->getLine());
+        }
+
+        Value visitVariableExpr(Variable<Value>* expr) {
+            return describe("variable " + std::string(expr->name->getLexeme()), expr->name->getLine());
+        }
+
+        Value visitBlockStmt(Block<Value>* stmt) {
+            return describe("block", stmt->statements.empty() ? 0 : lineOf(stmt->statements[0]));
+        }
+
+        Value visitExpressionStmt(Expression<Value>* stmt) {
+            return describe("expression", lineOf(stmt->expression));
+        }
+
+        Value visitFunctionStmt(Function<Value>* stmt) {
+            return describe("fun " + std::string(stmt->name->getLexeme()), stmt->name->getLine());
+        }
+
+        Value visitIfStmt(If<Value>* stmt) {
+            return describe("if", lineOf(stmt->condition));
+        }
+
+        Value visitPrintStmt(Print<Value>* stmt) {
+            return describe("print", lineOf(stmt->expression));
+        }
+
+        Value visitReturnStmt(Return<Value>* stmt) {
+            return describe("return", stmt->keyword->getLine());
+        }
+
+        Value visitVarStmt(Var<Value>* stmt) {
+            return describe("var " + std::string(stmt->name->getLexeme()), stmt->name->getLine());
+        }
+
+        Value visitVarLiteralStmt(VarLiteral<Value>* stmt) {
+            return describe("var " + std::string(stmt->name->getLexeme()), stmt->name->getLine());
+        }
+
+        Value visitWhileStmt(While<Value>* stmt) {
+            return describe("while", lineOf(stmt->condition));
+        }
+};
+
+NodeStat& NodeStats::statFor(Expr<Value>* expr) {
+    auto found = nodes.find(expr);
+    if (found != nodes.end()) {
+        return found->second;
+    }
+    NodeStat& stat = nodes[expr];
+    NodeDescriber describer(stat);
+    expr->accept(&describer);
+    return stat;
+}
+
+NodeStat& NodeStats::statFor(Stmt<Value>* stmt) {
+    auto found = nodes.find(stmt);
+    if (found != nodes.end()) {
+        return found->second;
+    }
+    NodeStat& stat = nodes[stmt];
+    NodeDescriber describer(stat);
+    stmt->accept(&describer);
+    return stat;
+}
+
+NodeStat& NodeStats::functionStatFor(Function<Value>* function) {
+    auto found = functions.find(function);
+    if (found != functions.end()) {
+        return found->second;
+    }
+    NodeStat& stat = functions[function];
+    stat.label = std::string(function->name->getLexeme());
+    stat.line = function->name->getLine();
+    return stat;
+}
+
+static std::vector<const NodeStat*> bySelfTime(const std::unordered_map<const void*, NodeStat>& stats) {
+    std::vector<const NodeStat*> sorted;
+    for (const auto& entry : stats) {
+        sorted.push_back(&entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const NodeStat* a, const NodeStat* b) {
+        return a->selfNs > b->selfNs;
+    });
+    return sorted;
+}
+
+static void printRow(std::ostream& out, const NodeStat& stat) {
+    out << std::setw(10) << stat.selfNs / 1e6 << std::setw(11) << stat.totalNs / 1e6
+        << std::setw(12) << stat.count << std::setw(6) << stat.line << "  " << stat.label << std::endl;
+}
+
+void NodeStats::report(std::ostream& out, size_t limit) {
+    std::vector<const NodeStat*> sortedNodes = bySelfTime(nodes);
+    std::vector<const NodeStat*> sortedFunctions = bySelfTime(functions);
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(3);
+
+    out << "[nodes] " << nodes.size() << " nodes executed, hottest by self time" << std::endl;
+    out << "   self ms   total ms       count  line  node" << std::endl;
+    for (size_t i = 0; i < sortedNodes.size() && i < limit; i++) {
+        printRow(out, *sortedNodes[i]);
+    }
+
+    out << "[nodes] " << functions.size() << " functions called, by self time" << std::endl;
+    out << "   self ms   total ms       count  line  function" << std::endl;
+    for (const NodeStat* stat : sortedFunctions) {
+        printRow(out, *stat);
+    }
+    out.flags(flags);
+}
@@ -0,0 +1,80 @@
+#ifndef NODE_STATS_H
+#define NODE_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "value.h"
+#include "expr.h"
+#include "stmt.h"
+
+// Counters for one syntax tree node or one Lox function.
+class NodeStat {
+    public:
+        std::string label;
+        int line = 0;
+        size_t count = 0;
+        uint64_t totalNs = 0;
+        uint64_t selfNs = 0;
+};
+
+// Execution counts and time per node for the tree-walking interpreter. The
+// interpreter only feeds this when built with -DICARUS_NODE_STATS
+// (make NODE_STATS=1); a normal build has no timing code in evaluate() or
+// execute() at all.
+//
+// Self time is a node's time minus the time of the nodes it evaluated. Nodes
+// and functions are timed on separate stacks, so a function's self time is
+// what it spent outside the Lox functions it called. Total time of a
+// recursive function or node counts the nested activations again.
+class NodeStats {
+    private:
+        std::unordered_map<const void*, NodeStat> nodes;
+        std::unordered_map<const void*, NodeStat> functions;
+
+    public:
+        // child time of every node and function currently running
+        std::vector<uint64_t> runningNodes;
+        std::vector<uint64_t> runningFunctions;
+
+        NodeStat& statFor(Expr<Value>* expr);
+        NodeStat& statFor(Stmt<Value>* stmt);
+        NodeStat& functionStatFor(Function<Value>* function);
+
+        // the hottest limit nodes, then every function, by self time
+        void report(std::ostream& out, size_t limit);
+};
+
+// Times one node or function call for as long as it is in scope, including
+// when a runtime error unwinds through it.
+class NodeTimer {
+    private:
+        std::vector<uint64_t>& running;
+        NodeStat& stat;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        NodeTimer(std::vector<uint64_t>& running, NodeStat& stat) : running(running), stat(stat) {
+            running.push_back(0);
+            start = std::chrono::steady_clock::now();
+        }
+
+        ~NodeTimer() {
+            uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            uint64_t children = running.back();
+            running.pop_back();
+            stat.count++;
+            stat.totalNs += elapsed;
+            stat.selfNs += elapsed - children;
+            if (!running.empty()) {
+                running.back() += elapsed;
+            }
+        }
+};
+
+#endif
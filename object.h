@@ -0,0 +1,148 @@
+#ifndef OBJECT_H
+#define OBJECT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class GarbageCollector;
+
+// Base class of everything the garbage collector owns. Every object sits on
+// the collector's intrusive list and reports the objects it references
+// through trace() so the mark phase can follow them.
+class GcObject {
+    public:
+        bool marked = false;
+        // permanent objects (string literals from the source) are never swept
+        bool permanent = false;
+        GcObject* nextObject = nullptr;
+        // size() as of the last time the collector looked at this object
+        size_t trackedBytes = 0;
+
+        virtual void trace(GarbageCollector* gc) {}
+
+        // approximate number of heap bytes held by this object
+        virtual size_t size() = 0;
+
+        virtual ~GcObject() = default;
+};
+
+// Heap storage for string values. Strings are immutable once created, so a
+// single copy is shared between every Value that refers to it. Literals are
+// interned by the collector, which makes comparing two of them a pointer
+// comparison.
+//
+// Concatenating long strings makes a rope node that only points at its two
+// halves; the characters are copied into one buffer the first time anything
+// reads them, so building a string piece by piece copies it once instead of
+// once per piece.
+class IcarusString : public GcObject {
+    private:
+        std::string chars;
+        // both null once the string is flat
+        IcarusString* left;
+        IcarusString* right;
+        size_t charCount;
+        uint32_t hash;
+        bool hashed;
+
+        // Copies the leaves into one buffer, left to right. Ropes built by a
+        // loop lean all the way to one side, so the walk keeps its own stack
+        // rather than recursing once per piece.
+        void flatten() {
+            std::string flat;
+            flat.reserve(charCount);
+            std::vector<IcarusString*> pending = {right, left};
+            while (!pending.empty()) {
+                IcarusString* piece = pending.back();
+                pending.pop_back();
+                if (piece->left == nullptr) {
+                    flat += piece->chars;
+                }
+                else {
+                    pending.push_back(piece->right);
+                    pending.push_back(piece->left);
+                }
+            }
+            chars = std::move(flat);
+            left = nullptr;
+            right = nullptr;
+        }
+
+    public:
+        // set by the collector's intern table, never for runtime strings
+        bool interned = false;
+
+        IcarusString(std::string chars) {
+            this->chars = std::move(chars);
+            this->left = nullptr;
+            this->right = nullptr;
+            this->charCount = this->chars.size();
+            this->hash = 0;
+            this->hashed = false;
+        }
+
+        IcarusString(IcarusString* left, IcarusString* right) {
+            this->left = left;
+            this->right = right;
+            this->charCount = left->length() + right->length();
+            this->hash = 0;
+            this->hashed = false;
+        }
+
+        const std::string& str() {
+            if (left != nullptr) {
+                flatten();
+            }
+            return chars;
+        }
+
+        size_t length() {
+            return charCount;
+        }
+
+        // computed the first time a map or comparison asks for it
+        uint32_t hashCode() {
+            if (!hashed) {
+                hash = hashOf(str());
+                hashed = true;
+            }
+            return hash;
+        }
+
+        bool equals(IcarusString* other) {
+            if (this == other) {
+                return true;
+            }
+            // there is only ever one interned copy of any text
+            if (interned && other->interned) {
+                return false;
+            }
+            if (charCount != other->charCount) {
+                return false;
+            }
+            if (hashed && other->hashed && hash != other->hash) {
+                return false;
+            }
+            return str() == other->str();
+        }
+
+        // FNV-1a
+        static uint32_t hashOf(const std::string& chars) {
+            uint32_t hash = 2166136261u;
+            for (char c : chars) {
+                hash ^= (uint8_t) c;
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        void trace(GarbageCollector* gc);
+
+        size_t size() {
+            return sizeof(IcarusString) + chars.capacity();
+        }
+};
+
+#endif
@@ -0,0 +1,339 @@
+#include "optimizer.h"
+
+Optimizer::Optimizer(GarbageCollector* gc, Arena* arena) {
+    this->gc = gc;
+    this->arena = arena;
+    this->foldedExpr = nullptr;
+    this->simplifiedStmt = nullptr;
+}
+
+void Optimizer::optimize(std::vector<Stmt<Value>*>& statements) {
+    simplifyAll(statements);
+}
+
+Expr<Value>* Optimizer::fold(Expr<Value>* expr) {
+    expr->accept(this);
+    return foldedExpr;
+}
+
+Stmt<Value>* Optimizer::simplify(Stmt<Value>* stmt) {
+    stmt->accept(this);
+    return simplifiedStmt;
+}
+
+Stmt<Value>* Optimizer::simplifyBody(Stmt<Value>* stmt) {
+    Stmt<Value>* simplified = simplify(stmt);
+    if (simplified == nullptr) {
+        return arena->make<Block<Value>>(std::vector<Stmt<Value>*>());
+    }
+    return simplified;
+}
+
+void Optimizer::simplifyAll(std::vector<Stmt<Value>*>& statements) {
+    size_t kept = 0;
+    for (Stmt<Value>* stmt : statements) {
+        Stmt<Value>* simplified = simplify(stmt);
+        if (simplified != nullptr) {
+            statements[kept++] = simplified;
+        }
+    }
+    statements.resize(kept);
+}
+
+static Literal<Value>* asLiteral(Expr<Value>* expr) {
+    return dynamic_cast<Literal<Value>*>(expr);
+}
+
+static Variable<Value>* asVariable(Expr<Value>* expr) {
+    return dynamic_cast<Variable<Value>*>(expr);
+}
+
+static bool isOrdering(TokenType operation) {
+    return operation == GREATER || operation == GREATER_EQUAL || operation == LESS || operation == LESS_EQUAL;
+}
+
+// Mirrors Interpreter::visitBinaryExpr, returning false wherever it would
+// throw so the error is still reported when the code runs.
+bool Optimizer::foldBinary(TokenType operation, const Value& left, const Value& right, Value& result) {
+    switch (operation) {
+        case BANG_EQUAL:
+            result = !left.equals(right);
+            return true;
+        case EQUAL_EQUAL:
+            result = left.equals(right);
+            return true;
+        case PLUS:
+            if (left.isString() && right.isString()) {
+                // literals are permanent, so the tree can hold on to it
+                result = gc->newPermanentString(left.asString() + right.asString());
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (!left.isNumber() || !right.isNumber()) {
+        return false;
+    }
+    double a = left.asNumber();
+    double b = right.asNumber();
+    switch (operation) {
+        case PLUS: result = a + b; return true;
+        case MINUS: result = a - b; return true;
+        case STAR: result = a * b; return true;
+        case SLASH: result = a / b; return true;
+        case GREATER: result = a > b; return true;
+        case GREATER_EQUAL: result = a >= b; return true;
+        case LESS: result = a < b; return true;
+        case LESS_EQUAL: result = a <= b; return true;
+        default: return false;
+    }
+}
+
+// x = x + n or x = x - n, with n a number
+Expr<Value>* Optimizer::fuseAssign(Assign<Value>* expr) {
+    Binary<Value>* binary = dynamic_cast<Binary<Value>*>(expr->value);
+    if (binary == nullptr) {
+        return expr;
+    }
+    TokenType operation = binary->operation->getType();
+    Variable<Value>* variable = asVariable(binary->left);
+    Literal<Value>* amount = asLiteral(binary->right);
+    if ((operation != PLUS && operation != MINUS) || variable == nullptr
+            || amount == nullptr || !amount->value.isNumber()) {
+        return expr;
+    }
+    // the same slot at the same depth is the same variable
+    if (variable->slot.depth != expr->slot.depth || variable->slot.index != expr->slot.index) {
+        return expr;
+    }
+    double step = operation == PLUS ? amount->value.asNumber() : -amount->value.asNumber();
+    Increment<Value>* increment = arena->make<Increment<Value>>(expr, expr->name, binary->operation, step);
+    increment->slot = expr->slot;
+    return increment;
+}
+
+// x < y or x < literal, and the other orderings
+Expr<Value>* Optimizer::fuseBinary(Binary<Value>* expr) {
+    Variable<Value>* left = asVariable(expr->left);
+    if (!isOrdering(expr->operation->getType()) || left == nullptr) {
+        return expr;
+    }
+    if (Variable<Value>* right = asVariable(expr->right)) {
+        return arena->make<Compare<Value>>(expr, left, expr->operation, right, Value());
+    }
+    if (Literal<Value>* right = asLiteral(expr->right)) {
+        return arena->make<Compare<Value>>(expr, left, expr->operation, nullptr, right->value);
+    }
+    return expr;
+}
+
+Value Optimizer::visitAssignExpr(Assign<Value>* expr) {
+    expr->value = fold(expr->value);
+    foldedExpr = fuseAssign(expr);
+    return nullptr;
+}
+
+Value Optimizer::visitBinaryExpr(Binary<Value>* expr) {
+    expr->left = fold(expr->left);
+    expr->right = fold(expr->right);
+    foldedExpr = fuseBinary(expr);
+
+    Literal<Value>* left = asLiteral(expr->left);
+    Literal<Value>* right = asLiteral(expr->right);
+    Value result;
+    if (left != nullptr && right != nullptr
+            && foldBinary(expr->operation->getType(), left->value, right->value, result)) {
+        foldedExpr = arena->make<Literal<Value>>(result);
+    }
+    return nullptr;
+}
+
+Value Optimizer::visitCallExpr(Call<Value>* expr) {
+    expr->callee = fold(expr->callee);
+    for (Expr<Value>*& argument : expr->arguments) {
+        argument = fold(argument);
+    }
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitCompareExpr(Compare<Value>* expr) {
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitGroupingExpr(Grouping<Value>* expr) {
+    // parentheses only matter to the parser
+    foldedExpr = fold(expr->expression);
+    return nullptr;
+}
+
+Value Optimizer::visitIncrementExpr(Increment<Value>* expr) {
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitIndexExpr(Index<Value>* expr) {
+    expr->object = fold(expr->object);
+    expr->index = fold(expr->index);
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitListExpr(List<Value>* expr) {
+    // every evaluation makes a new list, so a list literal is never constant
+    for (Expr<Value>*& element : expr->elements) {
+        element = fold(element);
+    }
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitLiteralExpr(Literal<Value>* expr) {
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitLogicalExpr(Logical<Value>* expr) {
+    expr->left = fold(expr->left);
+    expr->right = fold(expr->right);
+    foldedExpr = expr;
+
+    Literal<Value>* left = asLiteral(expr->left);
+    if (left != nullptr) {
+        // the left operand decides whether it is the result or the right one is
+        bool shortCircuits = expr->operation->getType() == OR ? left->value.isTruthy() : !left->value.isTruthy();
+        foldedExpr = shortCircuits ? expr->left : expr->right;
+    }
+    return nullptr;
+}
+
+Value Optimizer::visitMapExpr(Map<Value>* expr) {
+    for (size_t i = 0; i < expr->keys.size(); i++) {
+        expr->keys[i] = fold(expr->keys[i]);
+        expr->values[i] = fold(expr->values[i]);
+    }
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitSetIndexExpr(SetIndex<Value>* expr) {
+    expr->object = fold(expr->object);
+    expr->index = fold(expr->index);
+    expr->value = fold(expr->value);
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitUnaryExpr(Unary<Value>* expr) {
+    expr->right = fold(expr->right);
+    foldedExpr = expr;
+
+    Literal<Value>* right = asLiteral(expr->right);
+    if (right == nullptr) {
+        return nullptr;
+    }
+    if (expr->operation->getType() == BANG) {
+        foldedExpr = arena->make<Literal<Value>>(Value(!right->value.isTruthy()));
+    }
+    else if (expr->operation->getType() == MINUS && right->value.isNumber()) {
+        foldedExpr = arena->make<Literal<Value>>(Value(-right->value.asNumber()));
+    }
+    return nullptr;
+}
+
+Value Optimizer::visitVariableExpr(Variable<Value>* expr) {
+    foldedExpr = expr;
+    return nullptr;
+}
+
+Value Optimizer::visitBlockStmt(Block<Value>* stmt) {
+    // an empty block still has to stay, it may be the body of a loop
+    simplifyAll(stmt->statements);
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitExpressionStmt(Expression<Value>* stmt) {
+    stmt->expression = fold(stmt->expression);
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitFunctionStmt(Function<Value>* stmt) {
+    simplifyAll(stmt->body);
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitIfStmt(If<Value>* stmt) {
+    stmt->condition = fold(stmt->condition);
+
+    Literal<Value>* condition = asLiteral(stmt->condition);
+    if (condition != nullptr) {
+        // branches are statements, never declarations, so either one can
+        // take the if's place without changing any scope
+        if (condition->value.isTruthy()) {
+            simplifiedStmt = simplify(stmt->thenBranch);
+        }
+        else {
+            simplifiedStmt = stmt->elseBranch == nullptr ? nullptr : simplify(stmt->elseBranch);
+        }
+        return nullptr;
+    }
+
+    stmt->thenBranch = simplifyBody(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr) {
+        stmt->elseBranch = simplify(stmt->elseBranch);
+    }
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitPrintStmt(Print<Value>* stmt) {
+    stmt->expression = fold(stmt->expression);
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitReturnStmt(Return<Value>* stmt) {
+    if (stmt->value != nullptr) {
+        stmt->value = fold(stmt->value);
+    }
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitVarStmt(Var<Value>* stmt) {
+    if (stmt->initializer != nullptr) {
+        stmt->initializer = fold(stmt->initializer);
+    }
+    simplifiedStmt = stmt;
+
+    Literal<Value>* initializer = asLiteral(stmt->initializer);
+    if (initializer != nullptr) {
+        simplifiedStmt = arena->make<VarLiteral<Value>>(stmt, stmt->name, initializer->value);
+    }
+    return nullptr;
+}
+
+Value Optimizer::visitVarLiteralStmt(VarLiteral<Value>* stmt) {
+    simplifiedStmt = stmt;
+    return nullptr;
+}
+
+Value Optimizer::visitWhileStmt(While<Value>* stmt) {
+    stmt->condition = fold(stmt->condition);
+
+    Literal<Value>* condition = asLiteral(stmt->condition);
+    if (condition != nullptr && !condition->value.isTruthy()) {
+        simplifiedStmt = nullptr;
+        return nullptr;
+    }
+
+    stmt->body = simplifyBody(stmt->body);
+    simplifiedStmt = stmt;
+    return nullptr;
+}
@@ -0,0 +1,77 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <vector>
+
+#include "value.h"
+#include "expr.h"
+#include "stmt.h"
+#include "gc.h"
+#include "arena.h"
+
+// Rewrites a resolved syntax tree before either engine runs it. Arithmetic,
+// comparisons, string concatenation, negation and logical operators whose
+// operands are all literals are replaced by their result, groupings by the
+// expression inside them, ifs with a literal condition by the branch that
+// would run and while loops whose condition is a literal false value are
+// removed. Anything that would raise a runtime error, such as adding a
+// number to a string, is left alone so the error still happens at runtime.
+//
+// Once folded, a few shapes that loops run over and over are fused into a
+// single node the interpreter handles in one visit: x = x + 1 and x = x - 1
+// (with any number) become an Increment, x < y and x < 10 (and the other
+// three orderings) a Compare, and var x = 0 (with any literal) a VarLiteral.
+// Each fused node keeps the tree it replaced, which the compiler and the
+// resolver still work from.
+//
+// Each visit records the node that should take the visited one's place;
+// a statement replaced by nullptr is dropped from its list.
+class Optimizer : public Expr<Value>::Visitor<Value>, public Stmt<Value>::Visitor<Value> {
+    private:
+        GarbageCollector* gc;
+        Arena* arena;
+        Expr<Value>* foldedExpr;
+        Stmt<Value>* simplifiedStmt;
+
+        Expr<Value>* fold(Expr<Value>* expr);
+        Stmt<Value>* simplify(Stmt<Value>* stmt);
+        // branch or loop body, which must stay a statement even when empty
+        Stmt<Value>* simplifyBody(Stmt<Value>* stmt);
+        void simplifyAll(std::vector<Stmt<Value>*>& statements);
+
+        bool foldBinary(TokenType operation, const Value& left, const Value& right, Value& result);
+        Expr<Value>* fuseAssign(Assign<Value>* expr);
+        Expr<Value>* fuseBinary(Binary<Value>* expr);
+
+    public:
+        Optimizer(GarbageCollector* gc, Arena* arena);
+
+        void optimize(std::vector<Stmt<Value>*>& statements);
+
+        Value visitAssignExpr(Assign<Value>* expr);
+        Value visitBinaryExpr(Binary<Value>* expr);
+        Value visitCallExpr(Call<Value>* expr);
+        Value visitCompareExpr(Compare<Value>* expr);
+        Value visitGroupingExpr(Grouping<Value>* expr);
+        Value visitIncrementExpr(Increment<Value>* expr);
+        Value visitIndexExpr(Index<Value>* expr);
+        Value visitListExpr(List<Value>* expr);
+        Value visitLiteralExpr(Literal<Value>* expr);
+        Value visitLogicalExpr(Logical<Value>* expr);
+        Value visitMapExpr(Map<Value>* expr);
+        Value visitSetIndexExpr(SetIndex<Value>* expr);
+        Value visitUnaryExpr(Unary<Value>* expr);
+        Value visitVariableExpr(Variable<Value>* expr);
+
+        Value visitBlockStmt(Block<Value>* stmt);
+        Value visitExpressionStmt(Expression<Value>* stmt);
+        Value visitFunctionStmt(Function<Value>* stmt);
+        Value visitIfStmt(If<Value>* stmt);
+        Value visitPrintStmt(Print<Value>* stmt);
+        Value visitReturnStmt(Return<Value>* stmt);
+        Value visitVarStmt(Var<Value>* stmt);
+        Value visitVarLiteralStmt(VarLiteral<Value>* stmt);
+        Value visitWhileStmt(While<Value>* stmt);
+};
+
+#endif
@@ -10,6 +10,8 @@
 #include "expr.h"
 #include "tokentype.h"
 #include "stmt.h"
+#include "arena.h"
+#include "error_reporter.h"
 
 template <typename R>
 class Parser {
@@ -17,12 +19,13 @@ class Parser {
 
         std::vector<Stmt<R>*> statements;
         class ParseError : public std::exception {};
-        Parser<R>(std::vector<Token*> tokens);
+        Parser<R>(std::vector<Token*> tokens, Arena* arena, ErrorReporter* errors);
         std::vector<Stmt<R>*> parse();
-        void clean();
 
     private:
         std::vector<Token *> tokens;
+        Arena* arena;
+        ErrorReporter* errors;
 
         int current;
 
@@ -70,8 +73,10 @@ class Parser {
 };
 
 template <typename R>
-Parser<R>::Parser(std::vector<Token*> tokens){
+Parser<R>::Parser(std::vector<Token*> tokens, Arena* arena, ErrorReporter* errors){
     this->tokens = tokens;
+    this->arena = arena;
+    this->errors = errors;
     this->current = 0;
 }
 
@@ -110,7 +115,7 @@ bool Parser<R>::check(TokenType type) {
 
 template <typename R>
 typename Parser<R>::ParseError* Parser<R>::error(Token* token, std::string message) {
-    Icarus::error(token, message);
+    errors->error(token, message);
     return new Parser::ParseError();
 }
 
@@ -159,18 +164,48 @@ template <typename R>
 
 template <typename R>
 Expr<R>* Parser<R>::primary() {
-    if (match({FALSE})) return new Literal<R>(false);
-    if (match({TRUE})) return new Literal<R>(true);
-    if (match({NIL})) return new Literal<R>(nullptr);
+    if (match({FALSE})) return arena->make<Literal<R>>(false);
+    if (match({TRUE})) return arena->make<Literal<R>>(true);
+    if (match({NIL})) return arena->make<Literal<R>>(nullptr);
 
-    if (match({NUMBER, STRING})) return new Literal<R>(previous()->getLiteral());
+    if (match({NUMBER, STRING})) return arena->make<Literal<R>>(previous()->getLiteral());
 
-    if(match({IDENTIFIER})) return new Variable<R>(previous());
+    if(match({IDENTIFIER})) return arena->make<Variable<R>>(previous());
 
     if (match({LEFT_PAREN})) {
         Expr<R>* expr = expression();
         consume(RIGHT_PAREN, "Expect \')\' after expression.");
-        return new Grouping(expr);
+        return arena->make<Grouping<R>>(expr);
+    }
+
+    if (match({LEFT_BRACKET})) {
+        Token* bracket = previous();
+        std::vector<Expr<R>*> elements;
+        if (!check(RIGHT_BRACKET)) {
+            do {
+                elements.push_back(expression());
+            }
+            while (match({COMMA}));
+        }
+        consume(RIGHT_BRACKET, "Expect \']\' after list elements.");
+        return arena->make<List<R>>(bracket, elements);
+    }
+
+    // a brace that starts a statement is a block, anywhere else a map
+    if (match({LEFT_BRACE})) {
+        Token* brace = previous();
+        std::vector<Expr<R>*> keys;
+        std::vector<Expr<R>*> values;
+        if (!check(RIGHT_BRACE)) {
+            do {
+                keys.push_back(expression());
+                consume(COLON, "Expect \':\' after map key.");
+                values.push_back(expression());
+            }
+            while (match({COMMA}));
+        }
+        consume(RIGHT_BRACE, "Expect \'}\' after map entries.");
+        return arena->make<Map<R>>(brace, keys, values);
     }
 
     throw error(peek(), "Expect expression");
@@ -189,7 +224,7 @@ Expr<R>* Parser<R>::finishCall(Expr<R>* callee) {
         while (match({COMMA}));
     }
     Token* paren = consume(RIGHT_PAREN, "Expect \')\' after arguments");
-    return new Call<R>(callee, paren, arguments);
+    return arena->make<Call<R>>(callee, paren, arguments);
 }
 
 template <typename R>
@@ -199,6 +234,12 @@ Expr<R>* Parser<R>::call() {
         if (match({LEFT_PAREN})) {
             expr = finishCall(expr);
         }
+        else if (match({LEFT_BRACKET})) {
+            Token* bracket = previous();
+            Expr<R>* index = expression();
+            consume(RIGHT_BRACKET, "Expect \']\' after index.");
+            expr = arena->make<Index<R>>(expr, bracket, index);
+        }
         else {
             break;
         }
@@ -211,7 +252,7 @@ Expr<R>* Parser<R>::unary() {
     while(match({BANG, MINUS})){
         Token* operation = previous();
         Expr<R>* right = unary();
-        return new Unary<R>(operation, right);
+        return arena->make<Unary<R>>(operation, right);
     }
     return call();
 }
@@ -222,7 +263,7 @@ Expr<R>* Parser<R>::factor() {
     while(match({SLASH, STAR})) {
         Token* operation = previous();
         Expr<R>* right = unary();
-        expr = new Binary<R>(expr, operation, right);
+        expr = arena->make<Binary<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -233,7 +274,7 @@ Expr<R>* Parser<R>::term() {
     while(match({MINUS, PLUS})) {
         Token* operation = previous();
         Expr<R>* right = factor();
-        expr = new Binary<R>(expr, operation, right);
+        expr = arena->make<Binary<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -245,7 +286,7 @@ Expr<R>* Parser<R>::comparison() {
     while(match({GREATER, GREATER_EQUAL, LESS, LESS_EQUAL})) {
         Token* operation = previous();
         Expr<R>* right = term();
-        expr = new Binary<R>(expr, operation, right);
+        expr = arena->make<Binary<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -257,7 +298,7 @@ Expr<R>* Parser<R>::equality() {
     while(match({BANG_EQUAL, EQUAL_EQUAL})){
         Token* operation = previous();
         Expr<R>* right = comparison();
-        expr = new Binary<R>(expr, operation, right);
+        expr = arena->make<Binary<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -268,7 +309,7 @@ Expr<R>* Parser<R>::logicalAnd() {
     while (match({AND})) {
         Token* operation = previous();
         Expr<R>* right = equality();
-        expr = new Logical(expr, operation, right);
+        expr = arena->make<Logical<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -279,7 +320,7 @@ Expr<R>* Parser<R>::logicalOr() {
     while (match({OR})) {
         Token* operation = previous();
         Expr<R>* right = logicalAnd();
-        expr = new Logical(expr, operation, right);
+        expr = arena->make<Logical<R>>(expr, operation, right);
     }
     return expr;
 }
@@ -291,11 +332,15 @@ Expr<R>* Parser<R>::assignment() {
         Token* equals = previous();
         Expr<R>* value = assignment();
 
-        if (dynamic_cast<Variable<std::any>*>(expr)) {
-            Token* name = (dynamic_cast<Variable<std::any>*>(expr))->name;
-            return new Assign<R>(name, value);
+        if (dynamic_cast<Variable<Value>*>(expr)) {
+            Token* name = (dynamic_cast<Variable<Value>*>(expr))->name;
+            return arena->make<Assign<R>>(name, value);
 
         }
+        else if (dynamic_cast<Index<R>*>(expr)) {
+            Index<R>* index = dynamic_cast<Index<R>*>(expr);
+            return arena->make<SetIndex<R>>(index->object, index->bracket, index->index, value);
+        }
 
         error(equals, "Invalid assignment target.");
     }
@@ -324,7 +369,7 @@ Stmt<R>* Parser<R>::function(std::string kind) {
 
     consume(LEFT_BRACE, "Expect \'{\' before " + kind + " body.");
     std::vector<Stmt<R>*> body = block();
-    return new Function<R>(name, parameters, body);
+    return arena->make<Function<R>>(name, parameters, body);
 }
 
 
@@ -334,7 +379,7 @@ template <typename R>
 Stmt<R>* Parser<R>::expressionStatement() {
     Expr<R>* expr = expression();
     consume(SEMICOLON, "Expect \';\' after expression");
-    return new Expression<R>(expr);
+    return arena->make<Expression<R>>(expr);
 }
 
 template <typename R>
@@ -355,7 +400,7 @@ Stmt<R>* Parser<R>::whileStatement() {
     consume(RIGHT_PAREN, "Expect \')\' after while condition");
 
     Stmt<R>* body = statement();
-    return new While<R>(condition, body);
+    return arena->make<While<R>>(condition, body);
 }
 
 template <typename R>
@@ -366,13 +411,13 @@ Stmt<R>* Parser<R>::returnStatement() {
         value = expression();
     }
     consume(SEMICOLON, "Expect \';\' after return value");
-    return new Return<R>(keyword, value);
+    return arena->make<Return<R>>(keyword, value);
 }
 template <typename R>
 Stmt<R>* Parser<R>::printStatement() {
     Expr<R>* value = expression();
     consume(SEMICOLON, "Expect \';\' after a value");
-    return new Print<R>(value);
+    return arena->make<Print<R>>(value);
 }
 
 template <typename R>
@@ -386,7 +431,7 @@ Stmt<R>* Parser<R>::ifStatement() {
     if (match({ELSE})) {
         elseBranch = statement();
     }
-    return new If<R>(condition, thenBranch, elseBranch);
+    return arena->make<If<R>>(condition, thenBranch, elseBranch);
 }
 
 template <typename R>
@@ -422,19 +467,19 @@ Stmt<R>* Parser<R>::forStatement() {
     if (increment != nullptr) {
         std::vector<Stmt<R>*> statements;
         statements.push_back(body);
-        statements.push_back(new Expression<R>(increment));
-        body = new Block<R>(statements);
+        statements.push_back(arena->make<Expression<R>>(increment));
+        body = arena->make<Block<R>>(statements);
     }
     if (condition == nullptr) {
-        condition = new Literal<R>(true);
+        condition = arena->make<Literal<R>>(true);
     }
-    body = new While<R>(condition, body);
+    body = arena->make<While<R>>(condition, body);
 
     if (initializer != nullptr) {
         std::vector<Stmt<R>*> statements;
         statements.push_back(initializer);
         statements.push_back(body);
-        body = new Block<R>(statements);
+        body = arena->make<Block<R>>(statements);
     }
 
     return body;
@@ -458,7 +503,7 @@ Stmt<R>* Parser<R>::statement() {
         return whileStatement();
     }
     if (match({LEFT_BRACE})) {
-        return new Block<R>(block());
+        return arena->make<Block<R>>(block());
     }
     return expressionStatement();
 }
@@ -473,7 +518,7 @@ Stmt<R>* Parser<R>::varDeclaration() {
     }
 
     consume(SEMICOLON, "Expect \';\' after variable declaration.");
-    return new Var<R>(name, initializer);
+    return arena->make<Var<R>>(name, initializer);
 }
 
 template <typename R>
@@ -498,11 +543,4 @@ std::vector<Stmt<R>*> Parser<R>::parse() {
     this->statements = statements;
     return statements;
 }
-
-template <typename R>
-void Parser<R>::clean() {
-    for (auto token : tokens) {
-        delete token;
-    }
-}
 #endif
@@ -0,0 +1,70 @@
+#include <fstream>
+#include <csignal>
+#include <sys/time.h>
+
+#include "profiler.h"
+
+// a signal handler may only touch atomics that never take a lock
+static_assert(std::atomic<int>::is_always_lock_free, "the tick count must be lock free");
+
+std::atomic<int> Profiler::pending(0);
+
+Profiler::Profiler(std::string path, int intervalMicros) {
+    this->path = path;
+    this->intervalMicros = intervalMicros;
+    this->samples = 0;
+}
+
+void Profiler::onTimer(int signal) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Profiler::start() {
+    struct sigaction action = {};
+    action.sa_handler = Profiler::onTimer;
+    // restart reads interrupted by the timer, e.g. the REPL waiting on stdin
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+
+    struct itimerval timer = {};
+    timer.it_interval.tv_sec = intervalMicros / 1000000;
+    timer.it_interval.tv_usec = intervalMicros % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void Profiler::stop() {
+    struct itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    pending.store(0);
+}
+
+void Profiler::record(const std::vector<ProfileFrame>& frames) {
+    // every tick since the last safe point is charged to this stack
+    size_t weight = pending.exchange(0);
+
+    std::string stack;
+    for (const ProfileFrame& frame : frames) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        stack += frame.name;
+        stack += ':';
+        stack += std::to_string(frame.line);
+    }
+    stacks[stack] += weight;
+    samples += weight;
+}
+
+size_t Profiler::write() {
+    std::ofstream out(path);
+    for (auto& entry : stacks) {
+        out << entry.first << " " << entry.second << "\n";
+    }
+    return samples;
+}
+
+const std::string& Profiler::getPath() {
+    return path;
+}
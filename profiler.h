@@ -0,0 +1,56 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+// One Lox function on the profiled call stack and the line it is at.
+class ProfileFrame {
+    public:
+        std::string_view name;
+        int line;
+        ProfileFrame(std::string_view name, int line) {
+            this->name = name;
+            this->line = line;
+        }
+};
+
+// Sampling profiler. A SIGPROF timer only bumps a counter; the interpreter
+// and vm check that counter at safe points (calls, binary operators, loop
+// back edges) and hand over their current call stack, so the signal handler
+// never touches interpreter state. Samples are written in the collapsed
+// stack format flamegraph.pl and speedscope read:
+//
+//     script:12;fib:3;fib:3 42
+class Profiler {
+    private:
+        std::string path;
+        int intervalMicros;
+        std::unordered_map<std::string, size_t> stacks;
+        size_t samples;
+
+        static void onTimer(int signal);
+
+    public:
+        // Timer ticks not yet attributed to a stack. SIGPROF may land on any
+        // thread, including one waiting for the script's thread to finish,
+        // so the count is atomic rather than just signal safe.
+        static std::atomic<int> pending;
+
+        Profiler(std::string path, int intervalMicros);
+
+        void start();
+        void stop();
+
+        void record(const std::vector<ProfileFrame>& frames);
+
+        // writes the collapsed stacks to path and returns the number of samples
+        size_t write();
+
+        const std::string& getPath();
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include <vector>
 #include <unordered_map>
-#include <any>
+#include "value.h"
 #include <string>
 #include <iostream>
 
@@ -9,26 +9,32 @@
 #include "resolver.h"
 #include "interpreter.h"
 #include "token.h"
-#include "icarus.h"
 
-Resolver::Resolver(Interpreter* interpreter) {
+Resolver::Resolver(Interpreter* interpreter, ErrorReporter* errors) {
     this->interpreter = interpreter;
+    this->errors = errors;
 }
-void Resolver::resolve(Stmt<std::any>* stmt) {
+void Resolver::resolve(Stmt<Value>* stmt) {
     stmt->accept(this);
 }
 
-void Resolver::resolve(Expr<std::any>* expr) {
+void Resolver::resolve(Expr<Value>* expr) {
     expr->accept(this);
 }
 
-void Resolver::resolve(std::vector<Stmt<std::any>*> stmts) {
-    for (Stmt<std::any>* stmt : stmts) {
+void Resolver::resolve(std::vector<Stmt<Value>*> stmts) {
+    for (Stmt<Value>* stmt : stmts) {
         resolve(stmt);
     }
 }
 
-void Resolver::resolveFunction(Function<std::any>* function) {
+void Resolver::resolveFunction(Function<Value>* function) {
+    // a function declared inside another one can outlive the call that
+    // made it, and keeps that call's environment alive with it
+    if (!functions.empty()) {
+        functions.back()->hasClosures = true;
+    }
+    functions.push_back(function);
     beginScope();
     for (Token* param : function->params) {
         declare(param);
@@ -36,14 +42,15 @@ void Resolver::resolveFunction(Function<std::any>* function) {
     }
     resolve(function->body);
     endScope();
+    functions.pop_back();
 }
 
 void Resolver::beginScope() {
-    unordered_map<std::string, bool>* temp = new unordered_map<std::string, bool>();
-    scopes.push_back(temp);
+    scopes.push_back(new Scope());
 }
 
 void Resolver::endScope() {
+    delete scopes.back();
     scopes.pop_back();
 }
 
@@ -51,26 +58,31 @@ void Resolver::declare(Token* name) {
     if (scopes.size() == 0) {
        return; 
     }
-    scopes.back()->insert({name->getLexeme(), false});
+    // every declaration gets its own slot, even one that redeclares a name,
+    // because the interpreter defines locals in declaration order
+    Scope* scope = scopes.back();
+    scope->variables.insert_or_assign(name->getLexeme(), ScopeVariable(false, scope->slotCount++));
 }
 
 void Resolver::define(Token* name) {
     if (scopes.size() == 0) return;
-    scopes.back()->at(name->getLexeme()) = true;
+    scopes.back()->variables.at(name->getLexeme()).defined = true;
 }
 
-void Resolver::resolveLocal(Expr<std::any>* expr, Token* name) {
+void Resolver::resolveLocal(Slot& slot, Token* name) {
     for (int i = scopes.size() - 1; i >= 0; i--) {
-        if ((scopes[i]->find(name->getLexeme()) != scopes[i]->end())) {
-            interpreter->resolve(expr, scopes.size() - 1 - i);
+        auto found = scopes[i]->variables.find(name->getLexeme());
+        if (found != scopes[i]->variables.end()) {
+            slot = Slot(scopes.size() - 1 - i, found->second.slot);
             return;
         }
     }
+    slot = Slot(-1, interpreter->globalSlot(std::string(name->getLexeme())));
 }
 
 
 //Resolving blocks
-std::any Resolver::visitBlockStmt(Block<std::any>* stmt) {
+Value Resolver::visitBlockStmt(Block<Value>* stmt) {
     beginScope();
     resolve(stmt->statements);
     endScope();
@@ -79,7 +91,7 @@ std::any Resolver::visitBlockStmt(Block<std::any>* stmt) {
 
 
 //Variables initialization
-std::any Resolver::visitVarStmt(Var<std::any>* stmt) {
+Value Resolver::visitVarStmt(Var<Value>* stmt) {
     declare(stmt->name);
     if (stmt->initializer) {
         resolve(stmt->initializer);
@@ -89,33 +101,26 @@ std::any Resolver::visitVarStmt(Var<std::any>* stmt) {
 }
 
 //Variable expressions
-std::any Resolver::visitVariableExpr(Variable<std::any>* expr) {
-    bool found = false;
-    std::string name = expr->name->getLexeme();
-
-    for (int i = scopes.size() - 1; i >= 0; i--) {
-        for (auto pr : *scopes[i]) {
-            if (pr.first == name) {
-                found = true;
-            }
+Value Resolver::visitVariableExpr(Variable<Value>* expr) {
+    if (!scopes.empty()) {
+        auto found = scopes.back()->variables.find(expr->name->getLexeme());
+        if (found != scopes.back()->variables.end() && !found->second.defined) {
+            errors->error(expr->name, "Can't read local variable in its own initializer");
         }
     }
-    if (!scopes.empty() && !found) {
-        Icarus::error(expr->name, "Can't read local variable in its own initializer");
-    }
-    resolveLocal(expr, expr->name);
+    resolveLocal(expr->slot, expr->name);
     return nullptr;
 }
 
 //Assign expressions
-std::any Resolver::visitAssignExpr(Assign<std::any>* expr) {
+Value Resolver::visitAssignExpr(Assign<Value>* expr) {
     resolve(expr->value);
-    resolveLocal(expr, expr->name);
+    resolveLocal(expr->slot, expr->name);
     return nullptr;
 }
 
 //Function declarations
-std::any Resolver::visitFunctionStmt(Function<std::any>* stmt) {
+Value Resolver::visitFunctionStmt(Function<Value>* stmt) {
     declare(stmt->name);
     define(stmt->name);
     resolveFunction(stmt);
@@ -123,13 +128,13 @@ std::any Resolver::visitFunctionStmt(Function<std::any>* stmt) {
 }
 
 //Expression statements
-std::any Resolver::visitExpressionStmt(Expression<std::any>* stmt) {
+Value Resolver::visitExpressionStmt(Expression<Value>* stmt) {
     resolve(stmt->expression);
     return nullptr;
 }
 
 //If statements
-std::any Resolver::visitIfStmt(If<std::any>* stmt) {
+Value Resolver::visitIfStmt(If<Value>* stmt) {
     resolve(stmt->condition);
     resolve(stmt->thenBranch);
     if (stmt->elseBranch) resolve(stmt->elseBranch);
@@ -137,63 +142,118 @@ std::any Resolver::visitIfStmt(If<std::any>* stmt) {
 }
 
 //Print statements
-std::any Resolver::visitPrintStmt(Print<std::any>* stmt) {
+Value Resolver::visitPrintStmt(Print<Value>* stmt) {
     resolve(stmt->expression);
     return nullptr;
 }
 
 //Return statements
-std::any Resolver::visitReturnStmt(Return<std::any>* stmt) {
+Value Resolver::visitReturnStmt(Return<Value>* stmt) {
     if (stmt->value) {
         resolve(stmt->value);
+        // nothing is left to do in the caller once a returned call finishes,
+        // so both engines can run it in place of the caller's frame
+        Call<Value>* call = dynamic_cast<Call<Value>*>(stmt->value);
+        if (call != nullptr && !functions.empty()) {
+            call->tail = true;
+        }
     }
     return nullptr;
 }
 
+Value Resolver::visitVarLiteralStmt(VarLiteral<Value>* stmt) {
+    resolve(stmt->original);
+    return nullptr;
+}
+
 //While statements
-std::any Resolver::visitWhileStmt(While<std::any>* stmt) {
+Value Resolver::visitWhileStmt(While<Value>* stmt) {
     resolve(stmt->condition);
     resolve(stmt->body);
     return nullptr;
 }
 
 //Binary expressions
-std::any Resolver::visitBinaryExpr(Binary<std::any>* expr) {
+Value Resolver::visitBinaryExpr(Binary<Value>* expr) {
     resolve(expr->left);
     resolve(expr->right);
     return nullptr;
 }
 
 //Call expressions
-std::any Resolver::visitCallExpr(Call<std::any>* expr) {
+Value Resolver::visitCallExpr(Call<Value>* expr) {
     resolve(expr->callee);
-    for (Expr<std::any>* argument : expr->arguments) {
+    for (Expr<Value>* argument : expr->arguments) {
         resolve(argument);
     }
     return nullptr;
 }
 
+// Fused nodes are only made after resolving, from trees that were resolved
+// already; resolving one again resolves the tree it replaced.
+Value Resolver::visitCompareExpr(Compare<Value>* expr) {
+    resolve(expr->original);
+    return nullptr;
+}
+
+Value Resolver::visitIncrementExpr(Increment<Value>* expr) {
+    resolve(expr->original);
+    return nullptr;
+}
+
 //Grouping expressions
-std::any Resolver::visitGroupingExpr(Grouping<std::any>* expr) {
+Value Resolver::visitGroupingExpr(Grouping<Value>* expr) {
     resolve(expr->expression);
     return nullptr;
 }
 
+//Index expressions
+Value Resolver::visitIndexExpr(Index<Value>* expr) {
+    resolve(expr->object);
+    resolve(expr->index);
+    return nullptr;
+}
+
+//List literals
+Value Resolver::visitListExpr(List<Value>* expr) {
+    for (Expr<Value>* element : expr->elements) {
+        resolve(element);
+    }
+    return nullptr;
+}
+
 //Literals
-std::any Resolver::visitLiteralExpr(Literal<std::any>* expr) {
+Value Resolver::visitLiteralExpr(Literal<Value>* expr) {
     return nullptr;
 }
 
 
 //Logical expressions
-std::any Resolver::visitLogicalExpr(Logical<std::any>* expr) {
+Value Resolver::visitLogicalExpr(Logical<Value>* expr) {
     resolve(expr->left);
     resolve(expr->right);
     return nullptr;
 }
 
+//Index assignments
+Value Resolver::visitSetIndexExpr(SetIndex<Value>* expr) {
+    resolve(expr->object);
+    resolve(expr->index);
+    resolve(expr->value);
+    return nullptr;
+}
+
+//Map literals
+Value Resolver::visitMapExpr(Map<Value>* expr) {
+    for (size_t i = 0; i < expr->keys.size(); i++) {
+        resolve(expr->keys[i]);
+        resolve(expr->values[i]);
+    }
+    return nullptr;
+}
+
 //Unary expressions
-std::any Resolver::visitUnaryExpr(Unary<std::any>* expr) {
+Value Resolver::visitUnaryExpr(Unary<Value>* expr) {
     resolve(expr->right);
     return nullptr;
 }
@@ -3,67 +3,105 @@
 
 #include <unordered_map>
 #include <vector>
-#include <any>
+#include "value.h"
 #include <string>
+#include <string_view>
 
 #include "expr.h"
 #include "stmt.h"
 #include "interpreter.h"
 #include "token.h"
+#include "error_reporter.h"
 
 
-class Resolver : public Expr<std::any>::Visitor<std::any>, public Stmt<std::any>::Visitor<std::any> {
+// A variable declared in a local scope: whether its initializer has finished
+// and the slot it will occupy in the scope's Environment.
+class ScopeVariable {
+    public:
+        bool defined;
+        int slot;
+        ScopeVariable(bool defined, int slot) {
+            this->defined = defined;
+            this->slot = slot;
+        }
+};
+
+class Scope {
+    public:
+        // keyed by interned identifier, which outlives the scope
+        unordered_map<std::string_view, ScopeVariable> variables;
+        int slotCount = 0;
+};
+
+class Resolver : public Expr<Value>::Visitor<Value>, public Stmt<Value>::Visitor<Value> {
     private:
         Interpreter* interpreter;
-        std::vector<unordered_map<std::string, bool>*> scopes;
+        ErrorReporter* errors;
+        std::vector<Scope*> scopes;
+        // declarations of the functions being resolved, innermost last
+        std::vector<Function<Value>*> functions;
 
-        void resolve(Stmt<std::any>* stmt);
-        void resolve(Expr<std::any>* expr);
-        void resolveFunction(Function<std::any>* function);
+        void resolve(Stmt<Value>* stmt);
+        void resolve(Expr<Value>* expr);
+        void resolveFunction(Function<Value>* function);
 
         void beginScope(); 
         void endScope();
 
         void declare(Token* name);
         void define(Token* name);
-        void resolveLocal(Expr<std::any>* expr, Token* name);
+        void resolveLocal(Slot& slot, Token* name);
 
     public:
-        Resolver(Interpreter* interpreter);
+        Resolver(Interpreter* interpreter, ErrorReporter* errors);
+
+        void resolve(std::vector<Stmt<Value>*> stmts);
+
+        Value visitBlockStmt(Block<Value>* stmt);
+
+        Value visitVarStmt(Var<Value>* stmt);
+
+        Value visitVarLiteralStmt(VarLiteral<Value>* stmt);
+
+        Value visitVariableExpr(Variable<Value>* stmt);
+
+        Value visitAssignExpr(Assign<Value>* expr);
+
+        Value visitFunctionStmt(Function<Value>* function);
 
-        void resolve(std::vector<Stmt<std::any>*> stmts);
+        Value visitExpressionStmt(Expression<Value>* stmt);
 
-        std::any visitBlockStmt(Block<std::any>* stmt);
+        Value visitIfStmt(If<Value>* stmt);
 
-        std::any visitVarStmt(Var<std::any>* stmt);
+        Value visitPrintStmt(Print<Value>* stmt);
 
-        std::any visitVariableExpr(Variable<std::any>* stmt);
+        Value visitReturnStmt(Return<Value>* stmt);
 
-        std::any visitAssignExpr(Assign<std::any>* expr);
+        Value visitWhileStmt(While<Value>* stmt);
 
-        std::any visitFunctionStmt(Function<std::any>* function);
+        Value visitBinaryExpr(Binary<Value>* stmt);
 
-        std::any visitExpressionStmt(Expression<std::any>* stmt);
+        Value visitCallExpr(Call<Value>* expr);
 
-        std::any visitIfStmt(If<std::any>* stmt);
+        Value visitCompareExpr(Compare<Value>* expr);
 
-        std::any visitPrintStmt(Print<std::any>* stmt);
+        Value visitGroupingExpr(Grouping<Value>* expr);
 
-        std::any visitReturnStmt(Return<std::any>* stmt);
+        Value visitIncrementExpr(Increment<Value>* expr);
 
-        std::any visitWhileStmt(While<std::any>* stmt);
+        Value visitIndexExpr(Index<Value>* expr);
 
-        std::any visitBinaryExpr(Binary<std::any>* stmt);
+        Value visitListExpr(List<Value>* expr);
 
-        std::any visitCallExpr(Call<std::any>* expr);
+        Value visitLiteralExpr(Literal<Value>* expr);
 
-        std::any visitGroupingExpr(Grouping<std::any>* expr);
+        Value visitLogicalExpr(Logical<Value>* expr);
 
-        std::any visitLiteralExpr(Literal<std::any>* expr);
+        Value visitMapExpr(Map<Value>* expr);
 
-        std::any visitLogicalExpr(Logical<std::any>* expr);
+        Value visitSetIndexExpr(SetIndex<Value>* expr);
 
-        std::any visitUnaryExpr(Unary<std::any>* expr);
+        Value visitUnaryExpr(Unary<Value>* expr);
 
 };
 
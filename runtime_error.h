@@ -8,7 +8,14 @@
 class RuntimeError : public std::runtime_error {
 public:
     Token* token;
-    RuntimeError(Token* token, const std::string& message) : std::runtime_error(message), token(token) {}
+    int line;
+    // calls in progress when the error happened, one per line, if the
+    // engine recorded them
+    std::string trace;
+    RuntimeError(Token* token, const std::string& message) : std::runtime_error(message), token(token), line(token->getLine()) {}
+
+    // used by the bytecode vm, which only keeps line numbers around
+    RuntimeError(int line, const std::string& message) : std::runtime_error(message), token(nullptr), line(line) {}
 
 };
 
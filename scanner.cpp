@@ -1,6 +1,7 @@
-#include <any>
+#include <charconv>
+
+#include "value.h"
 #include "scanner.h"
-#include "icarus.h"
 
 bool Scanner::isAtEnd() {
     return this->current >= this->source.size();
@@ -23,13 +24,62 @@ char Scanner::advance() {
     return this->source[current++];
 }
 
-void Scanner::addToken(TokenType type, std::any literal) {
-    std::string text = source.substr(start, current - start);
-    tokens.push_back(new Token(type, text, literal, line));
+// Text of the tokens whose text never changes: punctuation, operators and
+// keywords. Syntax trees keep some of these tokens, and can outlive their
+// source (the REPL reads each line over the last one), so their lexemes
+// point here rather than into the source.
+static std::string_view fixedLexeme(TokenType type) {
+    switch (type) {
+        case LEFT_PAREN: return "(";
+        case RIGHT_PAREN: return ")";
+        case LEFT_BRACE: return "{";
+        case RIGHT_BRACE: return "}";
+        case LEFT_BRACKET: return "[";
+        case RIGHT_BRACKET: return "]";
+        case COLON: return ":";
+        case COMMA: return ",";
+        case DOT: return ".";
+        case MINUS: return "-";
+        case PLUS: return "+";
+        case SEMICOLON: return ";";
+        case SLASH: return "/";
+        case STAR: return "*";
+        case BANG: return "!";
+        case BANG_EQUAL: return "!=";
+        case EQUAL: return "=";
+        case EQUAL_EQUAL: return "==";
+        case GREATER: return ">";
+        case GREATER_EQUAL: return ">=";
+        case LESS: return "<";
+        case LESS_EQUAL: return "<=";
+        case AND: return "and";
+        case CLASS: return "class";
+        case ELSE: return "else";
+        case FALSE: return "false";
+        case FUN: return "fun";
+        case FOR: return "for";
+        case IF: return "if";
+        case NIL: return "nil";
+        case OR: return "or";
+        case PRINT: return "print";
+        case RETURN: return "return";
+        case SUPER: return "super";
+        case THIS: return "this";
+        case TRUE: return "true";
+        case VAR: return "var";
+        case WHILE: return "while";
+        default: return "";
+    }
+}
+
+// String and number literals only point into the source; their value is
+// what the tree keeps.
+void Scanner::addToken(TokenType type, Value literal) {
+    tokens.push_back(arena->make<Token>(type, source.substr(start, current - start), literal, line));
 }
 
 void Scanner::addToken(TokenType type) {
-    addToken(type, nullptr);
+    tokens.push_back(arena->make<Token>(type, fixedLexeme(type), nullptr, line));
 }
 
 char Scanner::peek() {
@@ -56,12 +106,12 @@ void Scanner::parseString() {
         advance();
     }
     if (isAtEnd()) {
-        Icarus::error(line, "Unterminated String");
+        errors->error(line, "Unterminated String");
         return;
     }
     advance();
-    std::string value = source.substr(start + 1, current - start - 2);
-    addToken(STRING, value);
+    std::string value(source.substr(start + 1, current - start - 2));
+    addToken(STRING, gc->newPermanentString(value));
 }
 
 void Scanner::parseNumber() {
@@ -70,21 +120,64 @@ void Scanner::parseNumber() {
         advance();
         while(isDigit(peek())) advance();
     }
-    addToken(NUMBER, std::stod(source.substr(start, current - start)));
+    double value = 0;
+    std::from_chars(source.data() + start, source.data() + current, value);
+    addToken(NUMBER, value);
 }
 
 
+TokenType Scanner::checkKeyword(int begin, int length, const char* rest, TokenType type) {
+    if (current - start == begin + length && source.compare(start + begin, length, rest) == 0) {
+        return type;
+    }
+    return IDENTIFIER;
+}
+
+// Keywords are told apart from identifiers by switching on their leading
+// characters, so no keyword needs more than one short comparison.
+TokenType Scanner::identifierType() {
+    switch (source[start]) {
+        case 'a': return checkKeyword(1, 2, "nd", AND);
+        case 'c': return checkKeyword(1, 4, "lass", CLASS);
+        case 'e': return checkKeyword(1, 3, "lse", ELSE);
+        case 'f':
+            if (current - start > 1) {
+                switch (source[start + 1]) {
+                    case 'a': return checkKeyword(2, 3, "lse", FALSE);
+                    case 'o': return checkKeyword(2, 1, "r", FOR);
+                    case 'u': return checkKeyword(2, 1, "n", FUN);
+                }
+            }
+            break;
+        case 'i': return checkKeyword(1, 1, "f", IF);
+        case 'n': return checkKeyword(1, 2, "il", NIL);
+        case 'o': return checkKeyword(1, 1, "r", OR);
+        case 'p': return checkKeyword(1, 4, "rint", PRINT);
+        case 'r': return checkKeyword(1, 5, "eturn", RETURN);
+        case 's': return checkKeyword(1, 4, "uper", SUPER);
+        case 't':
+            if (current - start > 1) {
+                switch (source[start + 1]) {
+                    case 'h': return checkKeyword(2, 2, "is", THIS);
+                    case 'r': return checkKeyword(2, 2, "ue", TRUE);
+                }
+            }
+            break;
+        case 'v': return checkKeyword(1, 2, "ar", VAR);
+        case 'w': return checkKeyword(1, 4, "hile", WHILE);
+    }
+    return IDENTIFIER;
+}
+
 void Scanner::identifier() {
     while (isAlphaNumeric(peek())) advance();
-    std::string text = source.substr(start, current - start);
-    TokenType type;
-    if (keywords.find(text) != keywords.end()) {
-        type = keywords[text];
-    }
-    else {
-        type = IDENTIFIER;
+    TokenType type = identifierType();
+    if (type != IDENTIFIER) {
+        addToken(type);
+        return;
     }
-    addToken(type);
+    std::string_view name = symbols->intern(source.substr(start, current - start));
+    tokens.push_back(arena->make<Token>(IDENTIFIER, name, nullptr, line));
 }
 
 void Scanner::scanToken(){
@@ -94,6 +187,9 @@ void Scanner::scanToken(){
         case ')': addToken(RIGHT_PAREN); break;
         case '{': addToken(LEFT_BRACE); break;
         case '}': addToken(RIGHT_BRACE); break;
+        case '[': addToken(LEFT_BRACKET); break;
+        case ']': addToken(RIGHT_BRACKET); break;
+        case ':': addToken(COLON); break;
         case ',': addToken(COMMA); break;
         case '.': addToken(DOT); break;
         case '-': addToken(MINUS); break;
@@ -129,7 +225,7 @@ void Scanner::scanToken(){
                 identifier();
             }
             else {
-                Icarus::error(line, "Unexpected character."); break;
+                errors->error(line, "Unexpected character."); break;
             }
             break;
     }
@@ -137,27 +233,15 @@ void Scanner::scanToken(){
 
 
 
-Scanner::Scanner(std::string source) {
+Scanner::Scanner(std::string_view source, GarbageCollector* gc, SymbolTable* symbols, Arena* arena, ErrorReporter* errors) {
     this->source = source;
+    this->gc = gc;
+    this->symbols = symbols;
+    this->arena = arena;
+    this->errors = errors;
     this->start = 0;
     this->current = 0;
     this->line = 1;
-    keywords["and"] = AND;
-    keywords["class"] = CLASS;
-    keywords["else"] = ELSE;
-    keywords["false"] = FALSE;
-    keywords["for"] = FOR;
-    keywords["fun"] = FUN;
-    keywords["if"] = IF;
-    keywords["nil"] = NIL;
-    keywords["or"] = OR;
-    keywords["print"] = PRINT;
-    keywords["return"] = RETURN;
-    keywords["super"] = SUPER;
-    keywords["this"] = THIS;
-    keywords["true"] = TRUE;
-    keywords["var"] = VAR;
-    keywords["while"] = WHILE;
 }
 
 
@@ -166,12 +250,6 @@ std::vector<Token *> Scanner::scanTokens() {
         start = current;
         scanToken();
     }
-    this->tokens.push_back(new Token(END_OF_FILE, "", nullptr, line));
+    this->tokens.push_back(arena->make<Token>(END_OF_FILE, "", nullptr, line));
     return this->tokens;
 }
-
-void Scanner::clean() {
-    for (auto token : tokens) {
-        delete token;
-    }
-}
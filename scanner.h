@@ -2,21 +2,28 @@
 #define SCANNER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
-#include <any>
+#include "value.h"
 
 #include "tokentype.h"
 #include "token.h"
+#include "gc.h"
+#include "arena.h"
+#include "symbol_table.h"
+#include "error_reporter.h"
 
 class Scanner {
     private:
-        std::string source;
+        std::string_view source;
         std::vector<Token *> tokens;
         int start;
         int current;
         int line;
-        std::unordered_map<std::string, TokenType> keywords;
+        GarbageCollector* gc;
+        SymbolTable* symbols;
+        Arena* arena;
+        ErrorReporter* errors;
 
         bool isAtEnd();
 
@@ -28,7 +35,7 @@ class Scanner {
 
         char  advance();
 
-        void addToken(TokenType type, std::any literal);
+        void addToken(TokenType type, Value literal);
 
         void addToken(TokenType type);
 
@@ -42,15 +49,17 @@ class Scanner {
 
         void parseNumber();
 
+        TokenType checkKeyword(int begin, int length, const char* rest, TokenType type);
+
+        TokenType identifierType();
+
         void identifier();
 
         void scanToken();
 
     public:
-        Scanner(std::string source);
+        Scanner(std::string_view source, GarbageCollector* gc, SymbolTable* symbols, Arena* arena, ErrorReporter* errors);
 
         std::vector<Token *> scanTokens();
-
-        void clean();
 };
 #endif
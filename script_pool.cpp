@@ -0,0 +1,87 @@
+#include <sstream>
+
+#include "script_pool.h"
+
+ScriptPool::ScriptPool(size_t threads, bool useVM, size_t maxDepth) {
+    this->useVM = useVM;
+    this->maxDepth = maxDepth;
+    this->stopping = false;
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    bool sized = pthread_attr_setstacksize(&attributes, Session::stackBytes(maxDepth)) == 0;
+    for (size_t i = 0; i < threads; i++) {
+        pthread_t thread;
+        // without the larger stack the session starts a thread per script
+        if ((sized && pthread_create(&thread, &attributes, startWorker, this) == 0)
+                || pthread_create(&thread, nullptr, startWorker, this) == 0) {
+            workers.push_back(thread);
+        }
+    }
+    pthread_attr_destroy(&attributes);
+}
+
+ScriptPool::~ScriptPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (pthread_t thread : workers) {
+        pthread_join(thread, nullptr);
+    }
+}
+
+std::future<ScriptResult> ScriptPool::submit(std::string source) {
+    std::future<ScriptResult> result;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        jobs.emplace_back();
+        jobs.back().source = std::move(source);
+        result = jobs.back().result.get_future();
+    }
+    ready.notify_one();
+    return result;
+}
+
+size_t ScriptPool::size() {
+    return workers.size();
+}
+
+void* ScriptPool::startWorker(void* pool) {
+    static_cast<ScriptPool*>(pool)->work();
+    return nullptr;
+}
+
+void ScriptPool::work() {
+    Session session;
+    session.useVM = useVM;
+    session.maxDepth = maxDepth;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            ready.wait(guard, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job.result.set_value(runScript(session, job.source));
+    }
+}
+
+ScriptResult ScriptPool::runScript(Session& session, const std::string& source) {
+    std::ostringstream output;
+    std::ostringstream errors;
+    session.out = &output;
+    session.errors.out = &errors;
+
+    ScriptResult result;
+    result.result = session.run(source);
+    result.output = output.str();
+    result.errors = errors.str();
+    session.reset();
+    return result;
+}
@@ -0,0 +1,67 @@
+#ifndef SCRIPT_POOL_H
+#define SCRIPT_POOL_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+
+#include <pthread.h>
+
+#include "session.h"
+
+// What one script run by a ScriptPool printed and how it ended.
+class ScriptResult {
+    public:
+        RunResult result;
+        std::string output;
+        // compile errors, or the runtime error that stopped the script
+        std::string errors;
+};
+
+// Runs independent scripts concurrently on a fixed set of worker threads.
+// Each worker keeps one Session and resets it after every script, so
+// scripts never share globals or error state, while the heap, the engines
+// and the vm's stacks are set up once per worker rather than per script.
+// What a script prints is captured in its result rather than written to
+// std::cout. Scripts run in the order they were submitted, as many at once
+// as there are workers.
+//
+// Workers are started with the stack the interpreter needs for maxDepth
+// calls, so their sessions run in place instead of each starting a thread.
+class ScriptPool {
+    private:
+        class Job {
+            public:
+                std::string source;
+                std::promise<ScriptResult> result;
+        };
+
+        bool useVM;
+        size_t maxDepth;
+        std::vector<pthread_t> workers;
+        std::deque<Job> jobs;
+        std::mutex lock;
+        std::condition_variable ready;
+        bool stopping;
+
+        static void* startWorker(void* pool);
+        void work();
+        ScriptResult runScript(Session& session, const std::string& source);
+
+    public:
+        ScriptPool(size_t threads, bool useVM = false, size_t maxDepth = Interpreter::DEFAULT_MAX_DEPTH);
+        // finishes every script already submitted, then stops the workers
+        ~ScriptPool();
+
+        ScriptPool(const ScriptPool&) = delete;
+        ScriptPool& operator=(const ScriptPool&) = delete;
+
+        std::future<ScriptResult> submit(std::string source);
+
+        size_t size();
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include <pthread.h>
+#include <functional>
+
+#include "session.h"
+#include "scanner.h"
+#include "parser.h"
+#include "resolver.h"
+#include "compiler.h"
+#include "optimizer.h"
+#include "tools/astprinter.h"
+
+Session::Session() {
+    this->gc = new GarbageCollector();
+    this->symbols = new SymbolTable();
+    this->interpreter = new Interpreter(gc, &errors);
+    this->vm = nullptr;
+    this->useVM = false;
+    this->profiler = nullptr;
+    this->optimize = true;
+    this->dumpAst = false;
+    this->maxDepth = Interpreter::DEFAULT_MAX_DEPTH;
+    this->out = &std::cout;
+    for (const NativeSpec& spec : standardNatives()) {
+        defineNative(spec.name, spec.arity, spec.function);
+    }
+}
+
+Session::~Session() {
+    delete vm;
+    delete interpreter;
+    delete gc;
+    for (VmFunction* script : scripts) {
+        delete script;
+    }
+    for (Arena* arena : arenas) {
+        delete arena;
+    }
+    delete symbols;
+}
+
+void Session::defineNative(std::string_view name, int arity, NativeFn function) {
+    NativeFunction* native = gc->allocate<NativeFunction>(name, arity, function, gc);
+    // globals can be reassigned, so the native keeps itself alive
+    native->permanent = true;
+    natives.push_back(native);
+    interpreter->globals->define(std::string(name), native);
+    if (vm != nullptr) {
+        vm->defineGlobal(std::string(name), native);
+    }
+}
+
+void Session::reset() {
+    for (VmFunction* script : scripts) {
+        delete script;
+    }
+    scripts.clear();
+    for (Arena* arena : arenas) {
+        delete arena;
+    }
+    arenas.clear();
+    // the literals and identifiers went with the trees and compiled code
+    gc->forgetLiterals();
+    delete symbols;
+    symbols = new SymbolTable();
+
+    interpreter->resetGlobals();
+    if (vm != nullptr) {
+        vm->resetGlobals();
+    }
+    for (NativeFunction* native : natives) {
+        interpreter->globals->define(std::string(native->name()), native);
+        if (vm != nullptr) {
+            vm->defineGlobal(std::string(native->name()), native);
+        }
+    }
+#ifdef ICARUS_NODE_STATS
+    // keyed by nodes that are gone
+    interpreter->nodeStats = NodeStats();
+#endif
+    errors.reset();
+}
+
+// Native stack one Lox call takes in the interpreter, with room to spare for
+// the expressions it is in the middle of evaluating, and the stack of
+// everything else.
+static const size_t STACK_BYTES_PER_CALL = 8 * 1024;
+static const size_t BASE_STACK_BYTES = 8 * 1024 * 1024;
+
+size_t Session::stackBytes(size_t maxDepth) {
+    return BASE_STACK_BYTES + maxDepth * STACK_BYTES_PER_CALL;
+}
+
+static void* runBody(void* body) {
+    (*static_cast<std::function<void()>*>(body))();
+    return nullptr;
+}
+
+static size_t currentStackBytes() {
+    pthread_attr_t attributes;
+    size_t bytes = 0;
+    if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+        pthread_attr_getstacksize(&attributes, &bytes);
+        pthread_attr_destroy(&attributes);
+    }
+    return bytes;
+}
+
+// Runs body on a new thread with a stack of the given size and waits for it.
+// The stack is mapped by pthreads on demand, so an unused limit costs only
+// address space. A calling thread whose stack is already that large, such
+// as a ScriptPool worker, runs body itself. Returns false without running
+// body if there is no such stack to be had.
+static bool runWithStack(size_t bytes, std::function<void()> body) {
+    if (currentStackBytes() >= bytes) {
+        body();
+        return true;
+    }
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_t thread;
+    bool started = pthread_attr_setstacksize(&attributes, bytes) == 0
+        && pthread_create(&thread, &attributes, runBody, &body) == 0;
+    pthread_attr_destroy(&attributes);
+    if (started) {
+        pthread_join(thread, nullptr);
+    }
+    return started;
+}
+
+RunResult Session::run(std::string_view source) {
+    errors.reset();
+    // owns every token and syntax tree node of this source
+    Arena* arena = new Arena();
+
+    Scanner scanner(source, gc, symbols, arena, &errors);
+    std::vector<Token *> tokens = scanner.scanTokens();
+    Parser<Value> parser(tokens, arena, &errors);
+
+    std::vector<Stmt<Value>*> statements = parser.parse();
+
+    if (!errors.hadError) {
+        Resolver resolver(interpreter, &errors);
+        resolver.resolve(statements);
+    }
+
+    if (errors.hadError) {
+        delete arena;
+        return RUN_COMPILE_ERROR;
+    }
+
+    if (optimize) {
+        Optimizer optimizer(gc, arena);
+        optimizer.optimize(statements);
+    }
+    if (dumpAst) {
+        AstPrinter<Value> printer;
+        *errors.out << printer.print(statements);
+    }
+
+    if (useVM) {
+        if (vm == nullptr) {
+            vm = new VM(gc, &errors, maxDepth);
+            for (NativeFunction* native : natives) {
+                vm->defineGlobal(std::string(native->name()), native);
+            }
+        }
+        vm->profiler = profiler;
+        vm->out = out;
+        Compiler compiler(vm, &errors);
+        VmFunction* script = compiler.compile(statements);
+        if (script != nullptr) {
+            vm->interpret(script);
+            scripts.push_back(script);
+        }
+        // compiled code no longer refers to the tree
+        delete arena;
+    }
+    else {
+        interpreter->profiler = profiler;
+        interpreter->maxDepth = maxDepth;
+        interpreter->out = out;
+        bool ran = runWithStack(stackBytes(maxDepth), [&]() {
+            interpreter->interpret(statements);
+        });
+        if (!ran) {
+            // a smaller stack would crash where the limit promises an error
+            *errors.out << "Not enough memory for a stack of " << maxDepth << " calls." << std::endl;
+            errors.hadRuntimeError = true;
+        }
+        arenas.push_back(arena);
+    }
+
+    if (errors.hadError) {
+        return RUN_COMPILE_ERROR;
+    }
+    return errors.hadRuntimeError ? RUN_RUNTIME_ERROR : RUN_OK;
+}
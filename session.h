@@ -0,0 +1,88 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "gc.h"
+#include "symbol_table.h"
+#include "arena.h"
+#include "interpreter.h"
+#include "vm.h"
+#include "chunk.h"
+#include "profiler.h"
+#include "natives.h"
+#include "error_reporter.h"
+
+// How a call to run() ended.
+enum RunResult { RUN_OK, RUN_COMPILE_ERROR, RUN_RUNTIME_ERROR };
+
+// Everything that has to outlive a single call to run(): the heap, the
+// interned names, the interpreter or vm with their globals, and the syntax
+// trees that functions defined by earlier sources still point into. Each
+// REPL line (or each run() from a host program) only scans, resolves and
+// executes its own source against this state.
+//
+// Sessions share no state with each other, so different threads can each
+// run their own at the same time; one session must only be used by one
+// thread at a time. The exception is the profiler, which samples the whole
+// process: only one session at a time should have one.
+class Session {
+    private:
+        // arenas of earlier sources, kept because their functions may still be called
+        std::vector<Arena*> arenas;
+        // compiled top-level code of earlier sources, whose closures may still be live
+        std::vector<VmFunction*> scripts;
+        // defined in the vm's globals too once it is created
+        std::vector<NativeFunction*> natives;
+
+    public:
+        GarbageCollector* gc;
+        SymbolTable* symbols;
+        Interpreter* interpreter;
+        VM* vm;
+        bool useVM;
+        // set to sample every run of this session
+        Profiler* profiler;
+        // fold constants and prune dead branches before running
+        bool optimize;
+        // print each source's tree to errors.out before running it
+        bool dumpAst;
+        // Lox calls either engine allows to be in progress at once; the vm
+        // reads it when the first run with useVM creates it. The
+        // interpreter runs on a thread of its own whose stack is sized to
+        // hold that many, however small the calling thread's stack is. If
+        // no stack that large can be allocated, run() reports a runtime
+        // error instead of running the script.
+        size_t maxDepth;
+        // errors of the last run(), written to errors.out
+        ErrorReporter errors;
+        // where print writes, std::cout by default; run() hands it to whichever
+        // engine runs the script
+        std::ostream* out;
+
+        Session();
+        ~Session();
+
+        Session(const Session&) = delete;
+        Session& operator=(const Session&) = delete;
+
+        // makes function available to scripts as the global called name
+        void defineNative(std::string_view name, int arity, NativeFn function);
+
+        RunResult run(std::string_view source);
+
+        // Forgets every global, function, syntax tree and name earlier runs
+        // left behind, as if the session were new, but keeps its heap and
+        // engines for the next run. Whatever the earlier scripts allocated
+        // is left for the collector.
+        void reset();
+
+        // Native stack the interpreter needs for maxDepth calls. run() on a
+        // thread with at least this much runs in place; from any other
+        // thread it starts one with a stack this size.
+        static size_t stackBytes(size_t maxDepth);
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef SLOT_H
+#define SLOT_H
+
+// Where the resolver found a variable: how many scopes up from the one
+// using it, and the slot within that scope. Globals have depth -1 and index
+// the global table.
+class Slot {
+    public:
+        int depth;
+        int index;
+        Slot() {
+            this->depth = -1;
+            this->index = 0;
+        }
+        Slot(int depth, int index) {
+            this->depth = depth;
+            this->index = index;
+        }
+};
+
+#endif
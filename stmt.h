@@ -2,8 +2,10 @@
 #define STMT_H
 #include <vector>
 #include <string>
-#include <any>
+#include "value.h"
 #include "token.h"
+#include "slot.h"
+#include "inline_cache.h"
 using namespace std;
 
 template <typename R> class Block;
@@ -13,6 +15,7 @@ template <typename R> class If;
 template <typename R> class Print;
 template <typename R> class Return;
 template <typename R> class Var;
+template <typename R> class VarLiteral;
 template <typename R> class While;
 
 template <typename R>
@@ -28,6 +31,7 @@ public:
         virtual T visitPrintStmt (Print<R>* stmt) = 0;
         virtual T visitReturnStmt (Return<R>* stmt) = 0;
         virtual T visitVarStmt (Var<R>* stmt) = 0;
+        virtual T visitVarLiteralStmt (VarLiteral<R>* stmt) = 0;
         virtual T visitWhileStmt (While<R>* stmt) = 0;
         virtual ~Visitor() = default;
     };
@@ -66,6 +70,7 @@ public:
     Token* name;
     vector<Token*> params;
     vector<Stmt<R>*> body;
+    bool hasClosures = false;
     Function(Token* name, vector<Token*> params, vector<Stmt<R>*> body) {
         this->name=name;
         this->params=params;
@@ -132,6 +137,22 @@ public:
     }
 };
 
+template <typename R>
+class VarLiteral : public Stmt<R> {
+public:
+    Stmt<R>* original;
+    Token* name;
+    Value value;
+    VarLiteral(Stmt<R>* original, Token* name, Value value) {
+        this->original=original;
+        this->name=name;
+        this->value=value;
+    }
+    R accept(typename Stmt<R>::template Visitor<R>* visitor) override {
+        return visitor->visitVarLiteralStmt(this);
+    }
+};
+
 template <typename R>
 class While : public Stmt<R> {
 public:
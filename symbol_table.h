@@ -0,0 +1,36 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+// Keeps a single copy of every identifier the scanner has seen. intern()
+// returns a view of that copy, so identifier tokens stay valid after the
+// source they came from is gone, and two identifiers with the same name
+// always point at the same characters.
+class SymbolTable {
+    private:
+        // deque never moves its elements, so views into them stay valid
+        std::deque<std::string> names;
+        std::unordered_set<std::string_view> symbols;
+
+    public:
+        std::string_view intern(std::string_view name) {
+            auto found = symbols.find(name);
+            if (found != symbols.end()) {
+                return *found;
+            }
+            names.emplace_back(name);
+            std::string_view symbol = names.back();
+            symbols.insert(symbol);
+            return symbol;
+        }
+
+        size_t size() {
+            return names.size();
+        }
+};
+
+#endif
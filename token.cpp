@@ -1,19 +1,19 @@
 #include "token.h"
 #include "tokentype.h"
-#include <any>
+#include "value.h"
 
-Token::Token(TokenType type, std::string lexeme, std::any literal, int line) {
+Token::Token(TokenType type, std::string_view lexeme, Value literal, int line) {
     this->type = type;
     this->lexeme = lexeme;
     this->literal = literal;
     this->line = line;
 }
 
-std::any Token::getLiteral(){
+Value Token::getLiteral(){
     return this->literal;
 }
 
-std::string Token::getLexeme() {
+std::string_view Token::getLexeme() {
     return this->lexeme;
 }
 
@@ -3,35 +3,28 @@
 
 #include <ostream>
 #include <string>
-#include <any>
+#include <string_view>
+#include "value.h"
 #include "tokentype.h"
 
 class Token {
     private:
         TokenType type;
-        std::string lexeme;
-        std::any literal;
+        // points into the symbol table for identifiers, into the source for
+        // string and number literals, and at a constant for everything else
+        std::string_view lexeme;
+        Value literal;
         int line;
     public:
-        Token(TokenType type, std::string lexeme, std::any literal, int line);
+        Token(TokenType type, std::string_view lexeme, Value literal, int line);
         //operator<< overload for std::ostream allows you to print a Token object using std::cout
         friend std::ostream& operator<<(std::ostream& os, const Token& token) {
             os << static_cast<int>(token.type) << " " << token.lexeme << " ";
-            if (token.literal.has_value()) {
-                if (token.literal.type() == typeid(std::string)) {
-                    os << std::any_cast<std::string>(token.literal);
-                }
-
-                else if (token.literal.type() == typeid(int)) {
-                    os << std::any_cast<int>(token.literal);
-                }
-
-                else if (token.literal.type() == typeid(double)) {
-                    os << std::any_cast<double>(token.literal);
-                }
-                else {
-                    os << "Unknown type";
-                }
+            if (token.literal.isString()) {
+                os << token.literal.asString();
+            }
+            else if (token.literal.isNumber()) {
+                os << token.literal.asNumber();
             }
             else {
                 os << "null";
@@ -41,9 +34,9 @@ class Token {
 
         TokenType getType();
 
-        std::string getLexeme();
+        std::string_view getLexeme();
 
-        std::any getLiteral();
+        Value getLiteral();
 
         int getLine();
 
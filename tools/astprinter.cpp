@@ -25,7 +25,7 @@ class AstPrinter : public Expr<std::string>::Visitor<std::string> {
             std::vector<Expr<std::string>*> vec;
             vec.push_back(expr->left);
             vec.push_back(expr->right);
-            return parenthesize(expr->operation->getLexeme(), vec);
+            return parenthesize(std::string(expr->operation->getLexeme()), vec);
         }
 
         std::string visitGroupingExpr(Grouping<std::string>* expr) {
@@ -36,24 +36,14 @@ class AstPrinter : public Expr<std::string>::Visitor<std::string> {
         }
 
         std::string visitLiteralExpr(Literal<std::string>* expr) {
-            std::string valueAsString;
-            if (expr->value.has_value()) {
-                if (expr->value.type() == typeid(std::string)) {
-                    valueAsString = std::any_cast<std::string>(expr->value);
-                    return valueAsString;
-                }
-                else if (expr->value.type() == typeid(int)) {
-                    valueAsString = std::to_string(std::any_cast<int>(expr->value));
-                    return valueAsString;
-                }
-
-                else if (expr->value.type() == typeid(double)) {
-                    valueAsString = std::to_string(std::any_cast<double>(expr->value));
-                    return valueAsString;
-                }
-                else {
-                    return "Unknown type";
-                }
+            if (expr->value.isString()) {
+                return expr->value.asString();
+            }
+            else if (expr->value.isNumber()) {
+                return std::to_string(expr->value.asNumber());
+            }
+            else if (expr->value.isBool()) {
+                return expr->value.asBool() ? "true" : "false";
             }
             return "nil";
         }
@@ -61,14 +51,14 @@ class AstPrinter : public Expr<std::string>::Visitor<std::string> {
         std::string visitUnaryExpr(Unary<std::string>* expr) {
             std::vector<Expr<std::string>*> vec;
             vec.push_back(expr->right);
-            return parenthesize(expr->operation->getLexeme(), vec);
+            return parenthesize(std::string(expr->operation->getLexeme()), vec);
         }
 
         std::string visitAssignExpr(Assign<std::string>* expr) {
 
             std::vector<Expr<std::string>*> vec;
             vec.push_back(expr->value);
-            return parenthesize(expr->name->getLexeme() + "=", vec);
+            return parenthesize(std::string(expr->name->getLexeme()) + "=", vec);
         }
 
 
@@ -81,12 +71,48 @@ class AstPrinter : public Expr<std::string>::Visitor<std::string> {
             std::vector<Expr<std::string>*> vec;
             vec.push_back(expr->left);
             vec.push_back(expr->right);
-            return parenthesize(expr->operation->getLexeme(), vec);
+            return parenthesize(std::string(expr->operation->getLexeme()), vec);
+        }
+
+        std::string visitIndexExpr(Index<std::string>* expr) {
+            std::vector<Expr<std::string>*> vec;
+            vec.push_back(expr->object);
+            vec.push_back(expr->index);
+            return parenthesize("index", vec);
+        }
+
+        std::string visitListExpr(List<std::string>* expr) {
+            return parenthesize("list", expr->elements);
+        }
+
+        std::string visitMapExpr(Map<std::string>* expr) {
+            std::vector<Expr<std::string>*> vec;
+            for (int i = 0; i < expr->keys.size(); i++) {
+                vec.push_back(expr->keys[i]);
+                vec.push_back(expr->values[i]);
+            }
+            return parenthesize("map", vec);
+        }
+
+        std::string visitSetIndexExpr(SetIndex<std::string>* expr) {
+            std::vector<Expr<std::string>*> vec;
+            vec.push_back(expr->object);
+            vec.push_back(expr->index);
+            vec.push_back(expr->value);
+            return parenthesize("set-index", vec);
+        }
+
+        std::string visitCompareExpr(Compare<std::string>* expr) {
+            return expr->original->accept(this);
+        }
+
+        std::string visitIncrementExpr(Increment<std::string>* expr) {
+            return expr->original->accept(this);
         }
 
         std::string visitVariableExpr(Variable<std::string>* expr) {
             std::vector<Expr<std::string>*> vec;
-            return parenthesize("Variable: " + expr->name->getLexeme(), vec);
+            return parenthesize("Variable: " + std::string(expr->name->getLexeme()), vec);
         }
 };
 
@@ -4,68 +4,222 @@
 #include <vector>
 #include <string>
 #include <iostream>
-#include "expr.h"
-#include "token.h"
-#include "tokentype.h"
+#include "../expr.h"
+#include "../stmt.h"
+#include "../token.h"
+#include "../tokentype.h"
 
-class AstPrinter : public Expr<std::string>::Visitor<std::string> {
+// Prints a syntax tree as s-expressions, one statement per line and the
+// bodies of blocks, functions, branches and loops indented below them:
+//
+//     (var x (+ 1 (group 2)))
+//     (while (< i 10)
+//       (block
+//         (print i)))
+template <typename R>
+class AstPrinter : public Expr<R>::template Visitor<R>, public Stmt<R>::template Visitor<R> {
     private:
-        std::string parenthesize(std::string name, std::initializer_list<Expr<std::string>*> exprs) {
-            std::string result = "(";
-            result += name;
-            std::vector<Expr<std::string>*> vec(exprs);
-            for (int i = 0; i < vec.size(); i++) {
-                result += " ";
-                result += vec[i]->accept(this);
+        std::string out;
+        int depth = 0;
+
+        void parenthesize(std::string name, std::vector<Expr<R>*> exprs) {
+            out += "(" + name;
+            for (Expr<R>* expr : exprs) {
+                out += " ";
+                expr->accept(this);
             }
-            result += ")";
-            return result;
+            out += ")";
+        }
+
+        void nested(Stmt<R>* stmt) {
+            depth++;
+            out += "\n" + std::string(depth * 2, ' ');
+            stmt->accept(this);
+            depth--;
         }
+
     public:
-        std::string print(Expr<std::string>* expr) {
-            return expr->accept(this);
-        }
-        std::string visitBinaryExpr(Binary<std::string>* expr) {
-            return parenthesize(expr->operation->getLexeme(), {expr->left, expr->right});
-        }
-
-        std::string visitGroupingExpr(Grouping<std::string>* expr) {
-            return parenthesize("group", {expr->expression});
-        }
-
-        std::string visitLiteralExpr(Literal<std::string>* expr) {
-            std::string valueAsString;
-            if (expr->value.has_value()) {
-                if (expr->value.type() == typeid(std::string)) {
-                    valueAsString = std::any_cast<std::string>(expr->value);
-                    return valueAsString;
-                }
-                else if (expr->value.type() == typeid(int)) {
-                    valueAsString = std::to_string(std::any_cast<int>(expr->value));
-                    return valueAsString;
-                }
-
-                else if (expr->value.type() == typeid(double)) {
-                    valueAsString = std::to_string(std::any_cast<double>(expr->value));
-                    return valueAsString;
-                }
-                else {
-                    return "Unknown type";
-                }
+        std::string print(Expr<R>* expr) {
+            out.clear();
+            expr->accept(this);
+            return out;
+        }
+
+        std::string print(const std::vector<Stmt<R>*>& statements) {
+            std::string result;
+            for (Stmt<R>* stmt : statements) {
+                out.clear();
+                stmt->accept(this);
+                result += out + "\n";
+            }
+            return result;
+        }
+
+        R visitAssignExpr(Assign<R>* expr) {
+            parenthesize("= " + std::string(expr->name->getLexeme()), {expr->value});
+            return R();
+        }
+
+        R visitBinaryExpr(Binary<R>* expr) {
+            parenthesize(std::string(expr->operation->getLexeme()), {expr->left, expr->right});
+            return R();
+        }
+
+        R visitCallExpr(Call<R>* expr) {
+            std::vector<Expr<R>*> exprs = {expr->callee};
+            exprs.insert(exprs.end(), expr->arguments.begin(), expr->arguments.end());
+            parenthesize("call", exprs);
+            return R();
+        }
+
+        // fused nodes print what they fused into
+        R visitCompareExpr(Compare<R>* expr) {
+            Literal<R> constant(expr->constant);
+            Expr<R>* right = expr->right != nullptr ? (Expr<R>*) expr->right : &constant;
+            parenthesize("compare" + std::string(expr->operation->getLexeme()), {expr->left, right});
+            return R();
+        }
+
+        R visitGroupingExpr(Grouping<R>* expr) {
+            parenthesize("group", {expr->expression});
+            return R();
+        }
+
+        R visitIncrementExpr(Increment<R>* expr) {
+            out += "(+= " + std::string(expr->name->getLexeme()) + " " + Value(expr->amount).toString() + ")";
+            return R();
+        }
+
+        R visitIndexExpr(Index<R>* expr) {
+            parenthesize("index", {expr->object, expr->index});
+            return R();
+        }
+
+        R visitListExpr(List<R>* expr) {
+            parenthesize("list", expr->elements);
+            return R();
+        }
+
+        R visitLiteralExpr(Literal<R>* expr) {
+            if (expr->value.isString()) {
+                out += "\"" + expr->value.toString() + "\"";
+            }
+            else if (expr->value.isBool()) {
+                out += expr->value.asBool() ? "true" : "false";
+            }
+            else {
+                out += expr->value.toString();
+            }
+            return R();
+        }
+
+        R visitLogicalExpr(Logical<R>* expr) {
+            parenthesize(std::string(expr->operation->getLexeme()), {expr->left, expr->right});
+            return R();
+        }
+
+        R visitMapExpr(Map<R>* expr) {
+            std::vector<Expr<R>*> entries;
+            for (size_t i = 0; i < expr->keys.size(); i++) {
+                entries.push_back(expr->keys[i]);
+                entries.push_back(expr->values[i]);
+            }
+            parenthesize("map", entries);
+            return R();
+        }
+
+        R visitSetIndexExpr(SetIndex<R>* expr) {
+            parenthesize("set-index", {expr->object, expr->index, expr->value});
+            return R();
+        }
+
+        R visitUnaryExpr(Unary<R>* expr) {
+            parenthesize(std::string(expr->operation->getLexeme()), {expr->right});
+            return R();
+        }
+
+        R visitVariableExpr(Variable<R>* expr) {
+            out += std::string(expr->name->getLexeme());
+            return R();
+        }
+
+        R visitBlockStmt(Block<R>* stmt) {
+            out += "(block";
+            for (Stmt<R>* statement : stmt->statements) {
+                nested(statement);
             }
-            return "nil";
-            /*
-            try {
-                return std::any_cast<std::string>(expr->value); 
-            } catch(const std::bad_any_cast&) {
-                return "nil";
+            out += ")";
+            return R();
+        }
+
+        R visitExpressionStmt(Expression<R>* stmt) {
+            parenthesize(";", {stmt->expression});
+            return R();
+        }
+
+        R visitFunctionStmt(Function<R>* stmt) {
+            out += "(fun " + std::string(stmt->name->getLexeme()) + " (";
+            for (size_t i = 0; i < stmt->params.size(); i++) {
+                out += (i > 0 ? " " : "") + std::string(stmt->params[i]->getLexeme());
             }
-            */
+            out += ")";
+            for (Stmt<R>* statement : stmt->body) {
+                nested(statement);
+            }
+            out += ")";
+            return R();
+        }
+
+        R visitIfStmt(If<R>* stmt) {
+            out += "(if ";
+            stmt->condition->accept(this);
+            nested(stmt->thenBranch);
+            if (stmt->elseBranch != nullptr) {
+                nested(stmt->elseBranch);
+            }
+            out += ")";
+            return R();
+        }
+
+        R visitPrintStmt(Print<R>* stmt) {
+            parenthesize("print", {stmt->expression});
+            return R();
+        }
+
+        R visitReturnStmt(Return<R>* stmt) {
+            if (stmt->value == nullptr) {
+                out += "(return)";
+            }
+            else {
+                parenthesize("return", {stmt->value});
+            }
+            return R();
+        }
+
+        R visitVarStmt(Var<R>* stmt) {
+            if (stmt->initializer == nullptr) {
+                out += "(var " + std::string(stmt->name->getLexeme()) + ")";
+            }
+            else {
+                parenthesize("var " + std::string(stmt->name->getLexeme()), {stmt->initializer});
+            }
+            return R();
+        }
 
+        R visitVarLiteralStmt(VarLiteral<R>* stmt) {
+            out += "(var " + std::string(stmt->name->getLexeme()) + " ";
+            Literal<R> value(stmt->value);
+            value.accept(this);
+            out += ")";
+            return R();
         }
 
-        std::string visitUnaryExpr(Unary<std::string>* expr) {
-            return parenthesize(expr->operation->getLexeme(), {expr->right});
+        R visitWhileStmt(While<R>* stmt) {
+            out += "(while ";
+            stmt->condition->accept(this);
+            nested(stmt->body);
+            out += ")";
+            return R();
         }
 };
- #endif
+#endif
@@ -0,0 +1,243 @@
+// Benchmark runner: executes every given Lox script under ./main on both
+// engines and prints one JSON document with wall time, retired
+// instructions, peak RSS, heap allocation counts and garbage collections
+// per benchmark.
+//
+//     ./bench [--main ./main] [--runs 3] [--label name] [--output file] benchmarks/*
+//
+// The JSON goes to --output, or stdout if none is given; progress goes to
+// stderr.
+//
+// Wall time and instructions are the minimum over all runs. Instructions are
+// read from a perf counter and reported as null where perf_event_open is not
+// permitted.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+class Measurement {
+    public:
+        bool ok = true;
+        double wallMs = 0;
+        long long instructions = -1;
+        long maxRssKb = 0;
+        long long allocations = -1;
+        long long allocatedBytes = -1;
+        long long collections = -1;
+};
+
+static int openInstructionCounter(pid_t pid) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+static void parseAllocStats(const std::string& output, Measurement& result) {
+    size_t at = output.rfind("[alloc] ");
+    if (at == std::string::npos) {
+        return;
+    }
+    std::istringstream line(output.substr(at + 8));
+    std::string word;
+    line >> result.allocations >> word >> result.allocatedBytes;
+}
+
+static void parseGcStats(const std::string& output, Measurement& result) {
+    size_t at = output.rfind("[gc] ");
+    if (at == std::string::npos) {
+        return;
+    }
+    std::istringstream line(output.substr(at + 5));
+    line >> result.collections;
+}
+
+static Measurement runOnce(const std::string& mainPath, const std::vector<std::string>& args) {
+    Measurement result;
+    int ready[2];
+    int errors[2];
+    if (pipe(ready) < 0 || pipe(errors) < 0) {
+        result.ok = false;
+        return result;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        // wait until the parent has attached the counter, then exec
+        close(ready[1]);
+        close(errors[0]);
+        char go;
+        if (read(ready[0], &go, 1) != 1) _exit(127);
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(devnull, STDOUT_FILENO);
+        dup2(errors[1], STDERR_FILENO);
+
+        std::vector<char*> argv;
+        argv.push_back((char*) mainPath.c_str());
+        for (const std::string& arg : args) {
+            argv.push_back((char*) arg.c_str());
+        }
+        argv.push_back(nullptr);
+        execv(mainPath.c_str(), argv.data());
+        _exit(127);
+    }
+
+    close(ready[0]);
+    close(errors[1]);
+    int counter = openInstructionCounter(child);
+
+    auto start = std::chrono::steady_clock::now();
+    if (write(ready[1], "g", 1) != 1) {
+        result.ok = false;
+    }
+    close(ready[1]);
+
+    std::string output;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(errors[0], buffer, sizeof(buffer))) > 0) {
+        output.append(buffer, count);
+    }
+    close(errors[0]);
+
+    int status;
+    struct rusage usage;
+    wait4(child, &status, 0, &usage);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.wallMs = elapsed.count();
+    result.maxRssKb = usage.ru_maxrss;
+    result.ok = result.ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (counter >= 0) {
+        long long instructions;
+        if (read(counter, &instructions, sizeof(instructions)) == sizeof(instructions)) {
+            result.instructions = instructions;
+        }
+        close(counter);
+    }
+    parseAllocStats(output, result);
+    parseGcStats(output, result);
+    return result;
+}
+
+static std::string quote(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+static std::string number(long long value) {
+    return value < 0 ? "null" : std::to_string(value);
+}
+
+int main(int argc, char** argv) {
+    std::string mainPath = "./main";
+    std::string label;
+    std::string outputPath;
+    int runs = 3;
+    std::vector<std::string> scripts;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--main" && i + 1 < argc) {
+            mainPath = argv[++i];
+        }
+        else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--label" && i + 1 < argc) {
+            label = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            scripts.push_back(arg);
+        }
+    }
+    if (scripts.empty()) {
+        std::cerr << "Usage: bench [--main path] [--runs n] [--label name] [--output file] script..." << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file) {
+            std::cerr << "Unable to open " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputPath.empty() ? std::cout : file;
+
+    std::vector<std::string> engines = {"tree", "vm"};
+    out << "{" << std::endl;
+    out << "  \"label\": " << quote(label) << "," << std::endl;
+    out << "  \"runs\": " << runs << "," << std::endl;
+    out << "  \"benchmarks\": [" << std::endl;
+    bool first = true;
+    bool allOk = true;
+    for (const std::string& script : scripts) {
+        std::string name = script.substr(script.find_last_of('/') + 1);
+        for (const std::string& engine : engines) {
+            std::vector<std::string> args = {"--alloc-stats", "--gc-stats"};
+            if (engine == "vm") {
+                args.push_back("--vm");
+            }
+            args.push_back(script);
+
+            Measurement best;
+            for (int run = 0; run < runs; run++) {
+                Measurement current = runOnce(mainPath, args);
+                if (run == 0) {
+                    best = current;
+                    continue;
+                }
+                best.ok = best.ok && current.ok;
+                best.wallMs = std::min(best.wallMs, current.wallMs);
+                if (current.instructions >= 0 && (best.instructions < 0 || current.instructions < best.instructions)) {
+                    best.instructions = current.instructions;
+                }
+                best.maxRssKb = std::max(best.maxRssKb, current.maxRssKb);
+            }
+            allOk = allOk && best.ok;
+
+            std::cerr << name << " (" << engine << "): " << best.wallMs << "ms" << (best.ok ? "" : " FAILED") << std::endl;
+            out << (first ? "" : ",\n");
+            first = false;
+            out << "    {\"name\": " << quote(name)
+                      << ", \"engine\": " << quote(engine)
+                      << ", \"ok\": " << (best.ok ? "true" : "false")
+                      << ", \"wall_ms\": " << best.wallMs
+                      << ", \"instructions\": " << number(best.instructions)
+                      << ", \"max_rss_kb\": " << best.maxRssKb
+                      << ", \"allocations\": " << number(best.allocations)
+                      << ", \"allocated_bytes\": " << number(best.allocatedBytes)
+                      << ", \"collections\": " << number(best.collections) << "}";
+        }
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+    return allOk ? 0 : 1;
+}
@@ -67,7 +67,7 @@ void defineVisitor(std::ostream& outFile, std::string baseName, std::vector<std:
     outFile << std::endl;
 }
 
-void defineType(std::ofstream& outFile, std::string baseName, std::string className, std::string fields) {
+void defineType(std::ofstream& outFile, std::string baseName, std::string className, std::string fields, std::string state) {
     outFile << "template <typename R>" << std::endl;
     outFile << "class " << className << " : public " << baseName << "<R> {" << std::endl;
     outFile << "public:" << std::endl;
@@ -76,6 +76,11 @@ void defineType(std::ofstream& outFile, std::string baseName, std::string classN
         fieldList[i] = trim(fieldList[i]);
         outFile << "    " << fieldList[i] << ";" << std::endl;
     }
+    // state filled in by later passes, not passed to the constructor
+    std::vector<std::string> stateList = splitString(state, ',');
+    for (int i = 0; i < stateList.size(); i++) {
+        outFile << "    " << trim(stateList[i]) << ";" << std::endl;
+    }
 
     outFile << "    " << className << "(" << fields << ") {" << std::endl;
     for (int i = 0; i < fieldList.size(); i++) {
@@ -103,8 +108,10 @@ void defineAst(std::string outputDir, std::string baseName, std::vector<std::str
     outFile << "#define " << toUppercase(baseName) << "_H" << std::endl; //Change accordingly
     outFile << "#include <vector>" << std::endl;
     outFile << "#include <string>" << std::endl;
-    outFile << "#include <any>" << std::endl;
+    outFile << "#include \"value.h\"" << std::endl;
     outFile << "#include \"token.h\"" << std::endl;
+    outFile << "#include \"slot.h\"" << std::endl;
+    outFile << "#include \"inline_cache.h\"" << std::endl;
     outFile << "using namespace std;" << std::endl;
     outFile << std::endl;
 
@@ -131,8 +138,10 @@ void defineAst(std::string outputDir, std::string baseName, std::vector<std::str
     for (std::string type: types ) {
         std::vector<std::string> processed = splitString(type, ':');
         std::string className = trim(processed[0]);
-        std::string fields = trim(processed[1]);
-        defineType(outFile, baseName, className, fields);
+        std::vector<std::string> sections = splitString(processed[1], '|');
+        std::string fields = trim(sections[0]);
+        std::string state = sections.size() > 1 ? trim(sections[1]) : "";
+        defineType(outFile, baseName, className, fields, state);
     }
     outFile << "#endif" << std::endl;
     outFile.close();
@@ -142,24 +151,31 @@ int main() {
     std::string outputDir = "..";
     
     std::vector<std::string> expressionTypes = {
-      "Assign   : Token* name, Expr<R>* value",
-      "Binary   : Expr<R>* left, Token* operation, Expr<R>* right",
-      "Call     : Expr<R>* callee, Token* paren, vector<Expr<R>*> arguments",
+      "Assign   : Token* name, Expr<R>* value | Slot slot, GlobalCache cache",
+      "Binary   : Expr<R>* left, Token* operation, Expr<R>* right | QuickBinary quick = QUICK_NONE",
+      "Call     : Expr<R>* callee, Token* paren, vector<Expr<R>*> arguments | bool tail = false",
+      "Compare  : Expr<R>* original, Variable<R>* left, Token* operation, Variable<R>* right, Value constant",
       "Grouping : Expr<R>* expression",
-      "Literal  : any value",
+      "Increment : Expr<R>* original, Token* name, Token* operation, double amount | Slot slot, GlobalCache cache",
+      "Index    : Expr<R>* object, Token* bracket, Expr<R>* index",
+      "List     : Token* bracket, vector<Expr<R>*> elements",
+      "Literal  : Value value",
       "Logical  : Expr<R>* left, Token* operation, Expr<R>* right", 
+      "Map      : Token* brace, vector<Expr<R>*> keys, vector<Expr<R>*> values",
+      "SetIndex : Expr<R>* object, Token* bracket, Expr<R>* index, Expr<R>* value",
       "Unary    : Token* operation, Expr<R>* right",
-      "Variable : Token* name"};
+      "Variable : Token* name | Slot slot, GlobalCache cache"};
     defineAst(outputDir, "Expr", expressionTypes);
     
     std::vector<std::string> statementTypes = {
     "Block : vector<Stmt<R>*> statements",
     "Expression : Expr<R>* expression", 
-    "Function : Token* name, vector<Token*> params, vector<Stmt<R>*> body",
+    "Function : Token* name, vector<Token*> params, vector<Stmt<R>*> body | bool hasClosures = false",
     "If : Expr<R>* condition, Stmt<R>* thenBranch, Stmt<R>* elseBranch",
     "Print : Expr<R>* expression",
     "Return : Token* keyword, Expr<R>* value",
     "Var : Token* name, Expr<R>* initializer",
+    "VarLiteral : Stmt<R>* original, Token* name, Value value",
     "While : Expr<R>* condition, Stmt<R>* body"};
     defineAst(outputDir, "Stmt", statementTypes);
 }
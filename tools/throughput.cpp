@@ -0,0 +1,137 @@
+// Throughput benchmark for ScriptPool: runs the given Lox scripts over and
+// over through pools of 1, 2, 4, ... worker threads, up to the number of
+// cores, and prints how many scripts each pool finishes per second.
+//
+//     ./throughput [--vm] [--scripts 2000] [--threads 1,2,8] samples/*
+//
+// Each script is first run once in a new session of its own to record what
+// it prints; every pooled run is checked against that, so state leaking from
+// one script into another shows up as a mismatch instead of a number.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <cstdlib>
+
+#include "../script_pool.h"
+
+static std::vector<size_t> parseThreads(const std::string& list) {
+    std::vector<size_t> counts;
+    std::istringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        int count = atoi(item.c_str());
+        if (count > 0) {
+            counts.push_back(count);
+        }
+    }
+    return counts;
+}
+
+static std::vector<size_t> defaultThreads() {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t count = 1; count < cores; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(cores);
+    return counts;
+}
+
+int main(int argc, char** argv) {
+    bool useVM = false;
+    int scriptCount = 2000;
+    std::vector<size_t> threadCounts = defaultThreads();
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--vm") {
+            useVM = true;
+        }
+        else if (arg == "--scripts" && i + 1 < argc) {
+            scriptCount = std::max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threadCounts = parseThreads(argv[++i]);
+        }
+        else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || threadCounts.empty()) {
+        std::cerr << "Usage: throughput [--vm] [--scripts n] [--threads n,n,...] script..." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> sources;
+    for (const std::string& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Unable to open " << path << std::endl;
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        sources.push_back(contents.str());
+    }
+
+    std::vector<ScriptResult> expected;
+    for (const std::string& source : sources) {
+        std::ostringstream output;
+        std::ostringstream errors;
+        Session session;
+        session.useVM = useVM;
+        session.out = &output;
+        session.errors.out = &errors;
+        ScriptResult result;
+        result.result = session.run(source);
+        result.output = output.str();
+        result.errors = errors.str();
+        expected.push_back(result);
+    }
+
+    std::cout << scriptCount << " runs of " << sources.size() << " scripts on the "
+              << (useVM ? "vm" : "tree-walker") << std::endl;
+    std::cout << "threads  scripts/s  speedup" << std::endl;
+    double baseline = 0;
+    bool allMatch = true;
+    for (size_t threads : threadCounts) {
+        ScriptPool pool(threads, useVM);
+        std::vector<std::future<ScriptResult>> results;
+        results.reserve(scriptCount);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scriptCount; i++) {
+            results.push_back(pool.submit(sources[i % sources.size()]));
+        }
+        int mismatches = 0;
+        for (int i = 0; i < scriptCount; i++) {
+            ScriptResult result = results[i].get();
+            const ScriptResult& want = expected[i % sources.size()];
+            if (result.result != want.result || result.output != want.output || result.errors != want.errors) {
+                mismatches++;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double rate = scriptCount / elapsed.count();
+        if (baseline == 0) {
+            baseline = rate;
+        }
+        std::cout << std::setw(7) << threads << "  "
+                  << std::setw(9) << std::fixed << std::setprecision(0) << rate << "  "
+                  << std::setw(6) << std::setprecision(2) << rate / baseline << "x";
+        if (mismatches > 0) {
+            std::cout << "  " << mismatches << " runs printed something else";
+            allMatch = false;
+        }
+        std::cout << std::endl;
+    }
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,284 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "object.h"
+
+class IcarusCallable;
+class IcarusList;
+class IcarusMap;
+
+enum ValueType {
+  VAL_NIL, VAL_BOOL, VAL_NUMBER, VAL_STRING, VAL_CALLABLE, VAL_LIST, VAL_MAP
+};
+
+// Runtime value of an icarus program. A type tag plus an 8 byte payload keeps
+// every value at 16 bytes, so numbers and booleans never touch the heap and
+// type checks are a single comparison instead of a typeid lookup. Strings and
+// callables point at objects owned by the garbage collector, which keeps
+// values trivially copyable.
+class Value {
+    private:
+        ValueType type;
+        union {
+            bool boolean;
+            double number;
+            IcarusString* string;
+            IcarusCallable* callable;
+            IcarusList* list;
+            IcarusMap* map;
+        } as;
+
+    public:
+        Value() {
+            type = VAL_NIL;
+            as.number = 0;
+        }
+
+        Value(std::nullptr_t) : Value() {}
+
+        Value(bool boolean) {
+            type = VAL_BOOL;
+            as.boolean = boolean;
+        }
+
+        Value(double number) {
+            type = VAL_NUMBER;
+            as.number = number;
+        }
+
+        Value(int number) : Value((double) number) {}
+
+        Value(IcarusString* string) {
+            type = VAL_STRING;
+            as.string = string;
+        }
+
+        Value(IcarusCallable* callable) {
+            type = VAL_CALLABLE;
+            as.callable = callable;
+        }
+
+        Value(IcarusList* list) {
+            type = VAL_LIST;
+            as.list = list;
+        }
+
+        Value(IcarusMap* map) {
+            type = VAL_MAP;
+            as.map = map;
+        }
+
+        ValueType getType() const { return type; }
+
+        bool isNil() const { return type == VAL_NIL; }
+        bool isBool() const { return type == VAL_BOOL; }
+        bool isNumber() const { return type == VAL_NUMBER; }
+        bool isString() const { return type == VAL_STRING; }
+        bool isCallable() const { return type == VAL_CALLABLE; }
+        bool isList() const { return type == VAL_LIST; }
+        bool isMap() const { return type == VAL_MAP; }
+
+        bool asBool() const { return as.boolean; }
+        double asNumber() const { return as.number; }
+        IcarusString* asStringObject() const { return as.string; }
+        const std::string& asString() const { return as.string->str(); }
+        IcarusCallable* asCallable() const { return as.callable; }
+        IcarusList* asList() const { return as.list; }
+        IcarusMap* asMap() const { return as.map; }
+
+        // nil and false are falsey, everything else is truthy
+        bool isTruthy() const {
+            if (isNil()) return false;
+            if (isBool()) return asBool();
+            return true;
+        }
+
+        bool equals(const Value& other) const {
+            if (type != other.type) {
+                return false;
+            }
+            switch (type) {
+                case VAL_NIL:
+                    return true;
+                case VAL_BOOL:
+                    return asBool() == other.asBool();
+                case VAL_NUMBER:
+                    return asNumber() == other.asNumber();
+                case VAL_STRING:
+                    return asStringObject()->equals(other.asStringObject());
+                case VAL_CALLABLE:
+                    return asCallable() == other.asCallable();
+                case VAL_LIST:
+                    // lists are mutable, so only the same list is equal to itself
+                    return asList() == other.asList();
+                case VAL_MAP:
+                    return asMap() == other.asMap();
+            }
+            return false;
+        }
+
+        std::string toString() const;
+
+    private:
+        // printing holds the lists and maps being printed, innermost last
+        std::string toString(std::vector<GcObject*>& printing) const;
+        // a list or map inside itself, however deeply, would print forever
+        bool isBeingPrinted(const std::vector<GcObject*>& printing) const;
+};
+
+// Heap storage for list values: the elements sit next to each other in one
+// buffer, so indexing is a bounds check and a load, and appending is
+// amortized constant time. trace() is defined in gc.cpp.
+class IcarusList : public GcObject {
+    public:
+        std::vector<Value> elements;
+
+        IcarusList() = default;
+
+        // Takes the elements before the list is allocated, so the collector
+        // counts their buffer from the start.
+        explicit IcarusList(std::vector<Value> elements) : elements(std::move(elements)) {}
+
+        // Checks that index is a whole number inside the list and stores the
+        // element's position; returns the problem otherwise.
+        const char* checkIndex(const Value& index, size_t& position) {
+            if (!index.isNumber()) {
+                return "List index must be a number";
+            }
+            double number = index.asNumber();
+            if (number < 0 || number >= elements.size() || number != (double) (size_t) number) {
+                return "List index out of range";
+            }
+            position = (size_t) number;
+            return nullptr;
+        }
+
+        void trace(GarbageCollector* gc);
+
+        size_t size() {
+            return sizeof(IcarusList) + elements.capacity() * sizeof(Value);
+        }
+};
+
+// Hash table from strings and numbers to values, using open addressing with
+// linear probing: entries live in one array whose size is a power of two, a
+// lookup hashes the key once and walks neighbouring entries until it finds
+// the key or an empty one. Deleted entries leave a tombstone behind so the
+// probe sequences running through them stay intact. Implemented in map.cpp.
+class IcarusMap : public GcObject {
+    private:
+        class Entry {
+            public:
+                // nil key: empty if value is nil, a tombstone if it is true
+                Value key;
+                Value value;
+        };
+
+        std::vector<Entry> entries;
+        // live entries, and live entries plus tombstones
+        size_t count;
+        size_t used;
+
+        Entry* find(const Value& key);
+        void grow();
+
+    public:
+        IcarusMap();
+
+        // nullptr if key can be used as a map key, otherwise the problem
+        static const char* checkKey(const Value& key);
+
+        // false if key is absent, otherwise stores the value
+        bool get(const Value& key, Value& value);
+        void set(const Value& key, const Value& value);
+        // false if key was absent
+        bool remove(const Value& key);
+
+        size_t length() {
+            return count;
+        }
+
+        // the keys in table order
+        void keys(std::vector<Value>& out);
+
+        void trace(GarbageCollector* gc);
+
+        size_t size() {
+            return sizeof(IcarusMap) + entries.capacity() * sizeof(Entry);
+        }
+};
+
+inline std::string Value::toString() const {
+    std::vector<GcObject*> printing;
+    return toString(printing);
+}
+
+inline bool Value::isBeingPrinted(const std::vector<GcObject*>& printing) const {
+    GcObject* container = isList() ? (GcObject*) asList() : (GcObject*) asMap();
+    for (GcObject* outer : printing) {
+        if (outer == container) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline std::string Value::toString(std::vector<GcObject*>& printing) const {
+    switch (type) {
+        case VAL_NIL:
+            return "nil";
+        case VAL_NUMBER:
+        {
+            std::string text = std::to_string(asNumber());
+            if (text.substr(text.size() - 2, 2) == ".0") {
+                text.erase(text.size() - 2);
+            }
+            return text;
+        }
+        case VAL_STRING:
+            return asString();
+        case VAL_BOOL:
+            return std::to_string(asBool());
+        case VAL_LIST:
+        {
+            if (isBeingPrinted(printing)) {
+                return "[...]";
+            }
+            printing.push_back(asList());
+            std::string text = "[";
+            for (size_t i = 0; i < asList()->elements.size(); i++) {
+                text += i > 0 ? ", " : "";
+                text += asList()->elements[i].toString(printing);
+            }
+            printing.pop_back();
+            return text + "]";
+        }
+        case VAL_MAP:
+        {
+            if (isBeingPrinted(printing)) {
+                return "{...}";
+            }
+            printing.push_back(asMap());
+            std::vector<Value> keys;
+            asMap()->keys(keys);
+            std::string text = "{";
+            for (size_t i = 0; i < keys.size(); i++) {
+                Value element;
+                asMap()->get(keys[i], element);
+                text += i > 0 ? ", " : "";
+                text += keys[i].toString() + ": ";
+                text += element.toString(printing);
+            }
+            printing.pop_back();
+            return text + "}";
+        }
+        default:
+            return "unsupported";
+    }
+}
+
+#endif
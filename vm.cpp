@@ -0,0 +1,511 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <new>
+
+#include <sys/mman.h>
+
+#include "vm.h"
+#include "runtime_error.h"
+
+// GCC and clang support taking the address of a label, which lets every
+// instruction jump straight to the handler of the next one instead of going
+// back through a single switch.
+#if defined(__GNUC__)
+#define ICARUS_COMPUTED_GOTO 1
+#else
+#define ICARUS_COMPUTED_GOTO 0
+#endif
+
+// Maps memory for count objects of type T without touching it. Untouched
+// pages read as zero bytes, which is a nil Value.
+template <typename T>
+static T* reserve(size_t count) {
+    void* memory = mmap(nullptr, count * sizeof(T), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T*>(memory);
+}
+
+VM::VM(GarbageCollector* gc, ErrorReporter* errors, size_t maxDepth) {
+    this->gc = gc;
+    this->profiler = nullptr;
+    this->errors = errors;
+    this->out = &std::cout;
+    this->maxFrames = maxDepth + 1;
+    this->frames = reserve<CallFrame>(maxFrames);
+    this->stack = reserve<Value>(maxFrames * SLOTS_PER_FRAME);
+    resetStack();
+    gc->addRoots(this);
+}
+
+VM::~VM() {
+    gc->removeRoots(this);
+    munmap(stack, maxFrames * SLOTS_PER_FRAME * sizeof(Value));
+    munmap(frames, maxFrames * sizeof(CallFrame));
+}
+
+void VM::markRoots(GarbageCollector* gc) {
+    for (Value* slot = stack; slot < stackTop; slot++) {
+        gc->markValue(*slot);
+    }
+    for (size_t i = 0; i < frameCount; i++) {
+        gc->markObject(frames[i].closure);
+    }
+    for (VmUpvalue* upvalue = openUpvalues; upvalue != nullptr; upvalue = upvalue->next) {
+        gc->markObject(upvalue);
+    }
+    for (Value& value : globals) {
+        gc->markValue(value);
+    }
+}
+
+void VM::resetStack() {
+    this->stackTop = stack;
+    this->frameCount = 0;
+    this->openUpvalues = nullptr;
+}
+
+void VM::push(Value value) {
+    *stackTop = value;
+    stackTop++;
+}
+
+Value VM::pop() {
+    stackTop--;
+    return *stackTop;
+}
+
+Value& VM::peek(int distance) {
+    return stackTop[-1 - distance];
+}
+
+int VM::globalSlot(std::string name) {
+    auto found = globalSlots.find(name);
+    if (found != globalSlots.end()) {
+        return found->second;
+    }
+    int slot = globals.size();
+    globals.push_back(Value());
+    defined.push_back(false);
+    globalNames.push_back(name);
+    globalSlots[name] = slot;
+    return slot;
+}
+
+void VM::defineGlobal(std::string name, Value value) {
+    int slot = globalSlot(name);
+    globals[slot] = value;
+    defined[slot] = true;
+}
+
+void VM::resetGlobals() {
+    globals.clear();
+    defined.clear();
+    globalNames.clear();
+    globalSlots.clear();
+    resetStack();
+}
+
+void VM::callValue(Value callee, int argCount, int line) {
+    if (!callee.isCallable()) {
+        throw new RuntimeError(line, "Can only call functions and classes");
+    }
+    IcarusCallable* callable = callee.asCallable();
+    if (argCount != callable->arity()) {
+        throw new RuntimeError(line, "Expected " + std::to_string(callable->arity()) + " arguments but got " + std::to_string(argCount));
+    }
+
+    VmClosure* closure = dynamic_cast<VmClosure*>(callable);
+    if (closure == nullptr) {
+        // natives read their arguments straight off the stack
+        NativeFunction* native = static_cast<NativeFunction*>(callable);
+        Value result;
+        try {
+            result = native->invoke(stackTop - argCount);
+        } catch (NativeError& error) {
+            throw new RuntimeError(line, error.what());
+        }
+        stackTop -= argCount + 1;
+        push(result);
+        return;
+    }
+
+    if (frameCount == maxFrames) {
+        RuntimeError* error = new RuntimeError(line, "Stack overflow.");
+        error->trace = ErrorReporter::stackTrace(callStack(), line);
+        throw error;
+    }
+    CallFrame* frame = &frames[frameCount++];
+    frame->closure = closure;
+    frame->ip = closure->function->chunk.code.data();
+    frame->slots = stackTop - argCount - 1;
+}
+
+VmUpvalue* VM::captureUpvalue(Value* local) {
+    VmUpvalue* previous = nullptr;
+    VmUpvalue* upvalue = openUpvalues;
+    while (upvalue != nullptr && upvalue->location > local) {
+        previous = upvalue;
+        upvalue = upvalue->next;
+    }
+    if (upvalue != nullptr && upvalue->location == local) {
+        return upvalue;
+    }
+
+    VmUpvalue* created = gc->allocate<VmUpvalue>(local);
+    created->next = upvalue;
+    if (previous == nullptr) {
+        openUpvalues = created;
+    }
+    else {
+        previous->next = created;
+    }
+    return created;
+}
+
+void VM::closeUpvalues(Value* last) {
+    while (openUpvalues != nullptr && openUpvalues->location >= last) {
+        VmUpvalue* upvalue = openUpvalues;
+        upvalue->closed = *upvalue->location;
+        upvalue->location = &upvalue->closed;
+        openUpvalues = upvalue->next;
+    }
+}
+
+// The functions running, outermost first, each at the line its saved ip is
+// on. The caller must have saved the running frame's ip.
+std::vector<ProfileFrame> VM::callStack() {
+    std::vector<ProfileFrame> stackFrames;
+    for (size_t i = 0; i < frameCount; i++) {
+        Chunk& chunk = frames[i].closure->function->chunk;
+        int offset = frames[i].ip - chunk.code.data() - 1;
+        stackFrames.push_back(ProfileFrame(frames[i].closure->function->name, chunk.lines[offset]));
+    }
+    return stackFrames;
+}
+
+// Hands the profiler the current call stack. The caller must have saved the
+// running frame's ip.
+void VM::sample() {
+    profiler->record(callStack());
+}
+
+void VM::run() {
+    CallFrame* frame = &frames[frameCount - 1];
+    uint8_t* ip = frame->ip;
+
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, (uint16_t)((ip[-2] << 8) | ip[-1]))
+#define CURRENT_LINE() (frame->closure->function->chunk.lines[ip - frame->closure->function->chunk.code.data() - 1])
+#define BINARY_OP(op)                                                          \
+    do {                                                                       \
+        if (!peek(0).isNumber() || !peek(1).isNumber()) {                      \
+            throw new RuntimeError(CURRENT_LINE(), "Operands must be numbers");\
+        }                                                                      \
+        double b = pop().asNumber();                                           \
+        double a = pop().asNumber();                                           \
+        push(a op b);                                                          \
+    } while (false)
+
+#if ICARUS_COMPUTED_GOTO
+    static void* dispatchTable[] = {
+        &&OP_CONSTANT, &&OP_NIL, &&OP_TRUE, &&OP_FALSE, &&OP_POP,
+        &&OP_GET_LOCAL, &&OP_SET_LOCAL,
+        &&OP_GET_GLOBAL, &&OP_DEFINE_GLOBAL, &&OP_SET_GLOBAL,
+        &&OP_GET_UPVALUE, &&OP_SET_UPVALUE,
+        &&OP_EQUAL, &&OP_GREATER, &&OP_LESS,
+        &&OP_ADD, &&OP_SUBTRACT, &&OP_MULTIPLY, &&OP_DIVIDE,
+        &&OP_NOT, &&OP_NEGATE,
+        &&OP_LIST, &&OP_MAP, &&OP_GET_INDEX, &&OP_SET_INDEX,
+        &&OP_PRINT, &&OP_JUMP, &&OP_JUMP_IF_FALSE, &&OP_LOOP,
+        &&OP_CALL, &&OP_TAIL_CALL, &&OP_CLOSURE, &&OP_CLOSE_UPVALUE, &&OP_RETURN
+    };
+#define DISPATCH() goto *dispatchTable[READ_BYTE()]
+#define CASE(name) name
+    DISPATCH();
+#else
+#define DISPATCH() continue
+#define CASE(name) case name
+    while (true) {
+    switch (READ_BYTE()) {
+#endif
+
+    CASE(OP_CONSTANT): {
+        push(frame->closure->function->chunk.constants[READ_SHORT()]);
+        DISPATCH();
+    }
+    CASE(OP_NIL): push(Value()); DISPATCH();
+    CASE(OP_TRUE): push(true); DISPATCH();
+    CASE(OP_FALSE): push(false); DISPATCH();
+    CASE(OP_POP): pop(); DISPATCH();
+
+    CASE(OP_GET_LOCAL): {
+        uint8_t slot = READ_BYTE();
+        push(frame->slots[slot]);
+        DISPATCH();
+    }
+    CASE(OP_SET_LOCAL): {
+        uint8_t slot = READ_BYTE();
+        frame->slots[slot] = peek(0);
+        DISPATCH();
+    }
+    CASE(OP_GET_GLOBAL): {
+        uint16_t slot = READ_SHORT();
+        if (!defined[slot]) {
+            throw new RuntimeError(CURRENT_LINE(), "Undefined variable: " + globalNames[slot] + ".");
+        }
+        push(globals[slot]);
+        DISPATCH();
+    }
+    CASE(OP_DEFINE_GLOBAL): {
+        uint16_t slot = READ_SHORT();
+        globals[slot] = pop();
+        defined[slot] = true;
+        DISPATCH();
+    }
+    CASE(OP_SET_GLOBAL): {
+        uint16_t slot = READ_SHORT();
+        if (!defined[slot]) {
+            throw new RuntimeError(CURRENT_LINE(), "Undefined variable: " + globalNames[slot] + ".");
+        }
+        globals[slot] = peek(0);
+        DISPATCH();
+    }
+    CASE(OP_GET_UPVALUE): {
+        uint8_t slot = READ_BYTE();
+        push(*frame->closure->upvalues[slot]->location);
+        DISPATCH();
+    }
+    CASE(OP_SET_UPVALUE): {
+        uint8_t slot = READ_BYTE();
+        *frame->closure->upvalues[slot]->location = peek(0);
+        DISPATCH();
+    }
+
+    CASE(OP_EQUAL): {
+        Value b = pop();
+        Value a = pop();
+        push(a.equals(b));
+        DISPATCH();
+    }
+    CASE(OP_GREATER): BINARY_OP(>); DISPATCH();
+    CASE(OP_LESS): BINARY_OP(<); DISPATCH();
+    CASE(OP_ADD): {
+        if (peek(0).isNumber() && peek(1).isNumber()) {
+            double b = pop().asNumber();
+            double a = pop().asNumber();
+            push(a + b);
+        }
+        else if (peek(0).isString() && peek(1).isString()) {
+            Value b = pop();
+            Value a = pop();
+            push(gc->concatenate(a.asStringObject(), b.asStringObject()));
+        }
+        else {
+            throw new RuntimeError(CURRENT_LINE(), "Operands must be two numbers or two strings");
+        }
+        DISPATCH();
+    }
+    CASE(OP_SUBTRACT): BINARY_OP(-); DISPATCH();
+    CASE(OP_MULTIPLY): BINARY_OP(*); DISPATCH();
+    CASE(OP_DIVIDE): BINARY_OP(/); DISPATCH();
+    CASE(OP_NOT): push(!pop().isTruthy()); DISPATCH();
+    CASE(OP_NEGATE): {
+        if (!peek(0).isNumber()) {
+            throw new RuntimeError(CURRENT_LINE(), "Operand must be a number");
+        }
+        push(-pop().asNumber());
+        DISPATCH();
+    }
+
+    CASE(OP_LIST): {
+        uint16_t count = READ_SHORT();
+        // the elements stay on the stack, and so rooted, until copied
+        IcarusList* list = gc->allocate<IcarusList>(std::vector<Value>(stackTop - count, stackTop));
+        stackTop -= count;
+        push(list);
+        DISPATCH();
+    }
+    CASE(OP_MAP): {
+        uint16_t count = READ_SHORT();
+        IcarusMap* map = gc->allocate<IcarusMap>();
+        for (Value* entry = stackTop - 2 * count; entry < stackTop; entry += 2) {
+            if (const char* problem = IcarusMap::checkKey(entry[0])) {
+                throw new RuntimeError(CURRENT_LINE(), problem);
+            }
+            map->set(entry[0], entry[1]);
+        }
+        stackTop -= 2 * count;
+        push(map);
+        gc->grew(map);
+        DISPATCH();
+    }
+    CASE(OP_GET_INDEX): {
+        if (peek(1).isMap()) {
+            if (const char* problem = IcarusMap::checkKey(peek(0))) {
+                throw new RuntimeError(CURRENT_LINE(), problem);
+            }
+            Value value;
+            peek(1).asMap()->get(peek(0), value);
+            stackTop -= 2;
+            push(value);
+            DISPATCH();
+        }
+        if (!peek(1).isList()) {
+            throw new RuntimeError(CURRENT_LINE(), "Only lists and maps can be indexed");
+        }
+        size_t position;
+        if (const char* problem = peek(1).asList()->checkIndex(peek(0), position)) {
+            throw new RuntimeError(CURRENT_LINE(), problem);
+        }
+        Value element = peek(1).asList()->elements[position];
+        stackTop -= 2;
+        push(element);
+        DISPATCH();
+    }
+    CASE(OP_SET_INDEX): {
+        if (peek(2).isMap()) {
+            if (const char* problem = IcarusMap::checkKey(peek(1))) {
+                throw new RuntimeError(CURRENT_LINE(), problem);
+            }
+            Value value = peek(0);
+            IcarusMap* map = peek(2).asMap();
+            map->set(peek(1), value);
+            gc->grew(map);
+            stackTop -= 3;
+            push(value);
+            DISPATCH();
+        }
+        if (!peek(2).isList()) {
+            throw new RuntimeError(CURRENT_LINE(), "Only lists and maps can be indexed");
+        }
+        size_t position;
+        if (const char* problem = peek(2).asList()->checkIndex(peek(1), position)) {
+            throw new RuntimeError(CURRENT_LINE(), problem);
+        }
+        Value value = peek(0);
+        peek(2).asList()->elements[position] = value;
+        stackTop -= 3;
+        push(value);
+        DISPATCH();
+    }
+
+    CASE(OP_PRINT): {
+        *out << pop().toString() << std::endl;
+        DISPATCH();
+    }
+    CASE(OP_JUMP): {
+        uint16_t offset = READ_SHORT();
+        ip += offset;
+        DISPATCH();
+    }
+    CASE(OP_JUMP_IF_FALSE): {
+        uint16_t offset = READ_SHORT();
+        if (!peek(0).isTruthy()) ip += offset;
+        DISPATCH();
+    }
+    CASE(OP_LOOP): {
+        uint16_t offset = READ_SHORT();
+        if (Profiler::pending && profiler != nullptr) {
+            frame->ip = ip;
+            sample();
+        }
+        ip -= offset;
+        DISPATCH();
+    }
+    CASE(OP_CALL): {
+        int argCount = READ_BYTE();
+        frame->ip = ip;
+        if (Profiler::pending && profiler != nullptr) {
+            sample();
+        }
+        callValue(peek(argCount), argCount, CURRENT_LINE());
+        frame = &frames[frameCount - 1];
+        ip = frame->ip;
+        DISPATCH();
+    }
+    CASE(OP_TAIL_CALL): {
+        int argCount = READ_BYTE();
+        frame->ip = ip;
+        if (Profiler::pending && profiler != nullptr) {
+            sample();
+        }
+        Value callee = peek(argCount);
+        VmClosure* closure = callee.isCallable() ? dynamic_cast<VmClosure*>(callee.asCallable()) : nullptr;
+        if (closure != nullptr && closure->arity() == argCount) {
+            // slide the callee and its arguments down over this frame's
+            // slots and let the call take the frame's place
+            Value* callStart = stackTop - argCount - 1;
+            closeUpvalues(frame->slots);
+            std::copy(callStart, stackTop, frame->slots);
+            stackTop = frame->slots + argCount + 1;
+            frameCount--;
+        }
+        callValue(callee, argCount, CURRENT_LINE());
+        frame = &frames[frameCount - 1];
+        ip = frame->ip;
+        DISPATCH();
+    }
+    CASE(OP_CLOSURE): {
+        VmFunction* function = frame->closure->function->chunk.functions[READ_SHORT()];
+        VmClosure* closure = gc->allocate<VmClosure>(function);
+        push(closure);
+        for (int i = 0; i < function->upvalueCount; i++) {
+            uint8_t isLocal = READ_BYTE();
+            uint8_t index = READ_BYTE();
+            if (isLocal) {
+                closure->upvalues[i] = captureUpvalue(frame->slots + index);
+            }
+            else {
+                closure->upvalues[i] = frame->closure->upvalues[index];
+            }
+        }
+        DISPATCH();
+    }
+    CASE(OP_CLOSE_UPVALUE): {
+        closeUpvalues(stackTop - 1);
+        pop();
+        DISPATCH();
+    }
+    CASE(OP_RETURN): {
+        Value result = pop();
+        closeUpvalues(frame->slots);
+        frameCount--;
+        if (frameCount == 0) {
+            pop();
+            return;
+        }
+        stackTop = frame->slots;
+        push(result);
+        frame = &frames[frameCount - 1];
+        ip = frame->ip;
+        DISPATCH();
+    }
+
+#if !ICARUS_COMPUTED_GOTO
+    }
+    }
+#endif
+
+#undef READ_BYTE
+#undef READ_SHORT
+#undef CURRENT_LINE
+#undef BINARY_OP
+#undef DISPATCH
+#undef CASE
+}
+
+void VM::interpret(VmFunction* script) {
+    VmClosure* closure = gc->allocate<VmClosure>(script);
+    push(closure);
+    try {
+        callValue(closure, 0, 0);
+        run();
+    } catch (RuntimeError* error) {
+        errors->runtimeError(error);
+        resetStack();
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef VM_H
+#define VM_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "value.h"
+#include "chunk.h"
+#include "gc.h"
+#include "icarus_callable.h"
+#include "profiler.h"
+#include "natives.h"
+#include "error_reporter.h"
+
+// A variable captured by a closure. While the variable is still on the VM
+// stack the upvalue points at its slot; once the slot goes away the value is
+// moved into the upvalue itself.
+class VmUpvalue : public GcObject {
+    public:
+        Value* location;
+        Value closed;
+        VmUpvalue* next;
+        VmUpvalue(Value* location) {
+            this->location = location;
+            this->next = nullptr;
+        }
+
+        void trace(GarbageCollector* gc) {
+            gc->markValue(closed);
+        }
+
+        size_t size() {
+            return sizeof(VmUpvalue);
+        }
+};
+
+// Runtime function value created by OP_CLOSURE.
+class VmClosure : public IcarusCallable {
+    public:
+        VmFunction* function;
+        std::vector<VmUpvalue*> upvalues;
+        VmClosure(VmFunction* function) {
+            this->function = function;
+            this->upvalues.resize(function->upvalueCount, nullptr);
+        }
+
+        int arity() {
+            return function->arity;
+        }
+
+        std::string_view name() {
+            return function->name;
+        }
+
+        // closures are only ever invoked by the vm's own dispatch loop
+        Value call(Interpreter* interpreter, const Value* arguments) {
+            return nullptr;
+        }
+
+        void trace(GarbageCollector* gc) {
+            for (VmUpvalue* upvalue : upvalues) {
+                gc->markObject(upvalue);
+            }
+        }
+
+        size_t size() {
+            return sizeof(VmClosure) + upvalues.capacity() * sizeof(VmUpvalue*);
+        }
+};
+
+class VM : public GcRoots {
+    private:
+        // a function has at most 256 locals and temporaries on the stack
+        static const size_t SLOTS_PER_FRAME = 256;
+
+        class CallFrame {
+            public:
+                VmClosure* closure;
+                uint8_t* ip;
+                Value* slots;
+        };
+
+        // Both are reserved for maxDepth calls up front, but pages are only
+        // backed once a call reaches them, so a deep limit costs address
+        // space rather than memory.
+        Value* stack;
+        Value* stackTop;
+        CallFrame* frames;
+        size_t maxFrames;
+        size_t frameCount;
+        VmUpvalue* openUpvalues;
+
+        std::vector<Value> globals;
+        std::vector<bool> defined;
+        std::vector<std::string> globalNames;
+        std::unordered_map<std::string, int> globalSlots;
+
+        GarbageCollector* gc;
+
+        void resetStack();
+        void push(Value value);
+        Value pop();
+        Value& peek(int distance);
+
+        void callValue(Value callee, int argCount, int line);
+        VmUpvalue* captureUpvalue(Value* local);
+        void closeUpvalues(Value* last);
+        std::vector<ProfileFrame> callStack();
+        void sample();
+        void run();
+
+    public:
+        Profiler* profiler;
+        ErrorReporter* errors;
+        std::ostream* out;
+
+        // allows maxDepth calls in progress at once on top of the script,
+        // like the interpreter
+        VM(GarbageCollector* gc, ErrorReporter* errors, size_t maxDepth);
+        ~VM();
+
+        void markRoots(GarbageCollector* gc);
+
+        // index of the global called name, allocating a new one if needed
+        int globalSlot(std::string name);
+
+        // defines a global before any script runs, used for natives
+        void defineGlobal(std::string name, Value value);
+
+        // starts over with no globals defined, keeping the stacks
+        void resetGlobals();
+
+        void interpret(VmFunction* script);
+};
+
+#endif